@@ -11,6 +11,164 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// assortcoef_cpp
+SEXP assortcoef_cpp(Rcpp::IntegerVector snode, Rcpp::IntegerVector tnode, Rcpp::NumericVector weight, int nnode, bool directed, int nthreads);
+RcppExport SEXP _wdnet_assortcoef_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP weightSEXP, SEXP nnodeSEXP, SEXP directedSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type snode(snodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type tnode(tnodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type nnode(nnodeSEXP);
+    Rcpp::traits::input_parameter< bool >::type directed(directedSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(assortcoef_cpp(snode, tnode, weight, nnode, directed, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// assortcoef_graph_cpp
+SEXP assortcoef_graph_cpp(SEXP graph, int nthreads);
+RcppExport SEXP _wdnet_assortcoef_graph_cpp(SEXP graphSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(assortcoef_graph_cpp(graph, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// assortcoef_file_cpp
+Rcpp::List assortcoef_file_cpp(std::string file, int nthreads);
+RcppExport SEXP _wdnet_assortcoef_file_cpp(SEXP fileSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(assortcoef_file_cpp(file, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// feature_assort_cpp
+Rcpp::NumericVector feature_assort_cpp(Rcpp::IntegerVector snode, Rcpp::IntegerVector tnode, Rcpp::NumericVector weight, Rcpp::NumericMatrix feature, Rcpp::IntegerMatrix pair, bool directed, int nthreads);
+RcppExport SEXP _wdnet_feature_assort_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP weightSEXP, SEXP featureSEXP, SEXP pairSEXP, SEXP directedSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type snode(snodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type tnode(tnodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type feature(featureSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type pair(pairSEXP);
+    Rcpp::traits::input_parameter< bool >::type directed(directedSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(feature_assort_cpp(snode, tnode, weight, feature, pair, directed, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// wpr_cpp
+Rcpp::List wpr_cpp(SEXP graph, Rcpp::NumericVector gamma, Rcpp::NumericVector theta, std::vector<double> prior, double tol, int max_iter, int nthreads, int extrapolate);
+RcppExport SEXP _wdnet_wpr_cpp(SEXP graphSEXP, SEXP gammaSEXP, SEXP thetaSEXP, SEXP priorSEXP, SEXP tolSEXP, SEXP max_iterSEXP, SEXP nthreadsSEXP, SEXP extrapolateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type gamma(gammaSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type theta(thetaSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type prior(priorSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type max_iter(max_iterSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type extrapolate(extrapolateSEXP);
+    rcpp_result_gen = Rcpp::wrap(wpr_cpp(graph, gamma, theta, prior, tol, max_iter, nthreads, extrapolate));
+    return rcpp_result_gen;
+END_RCPP
+}
+// closeness_cpp
+Rcpp::NumericVector closeness_cpp(SEXP graph, double alpha, bool out, bool harmonic, bool distance, int nthreads);
+RcppExport SEXP _wdnet_closeness_cpp(SEXP graphSEXP, SEXP alphaSEXP, SEXP outSEXP, SEXP harmonicSEXP, SEXP distanceSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< bool >::type out(outSEXP);
+    Rcpp::traits::input_parameter< bool >::type harmonic(harmonicSEXP);
+    Rcpp::traits::input_parameter< bool >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(closeness_cpp(graph, alpha, out, harmonic, distance, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// closeness_pivot_cpp
+Rcpp::List closeness_pivot_cpp(SEXP graph, double alpha, bool out, bool distance, Rcpp::IntegerVector pivot, Rcpp::IntegerVector stratum, int nstrata, int nthreads);
+RcppExport SEXP _wdnet_closeness_pivot_cpp(SEXP graphSEXP, SEXP alphaSEXP, SEXP outSEXP, SEXP distanceSEXP, SEXP pivotSEXP, SEXP stratumSEXP, SEXP nstrataSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< bool >::type out(outSEXP);
+    Rcpp::traits::input_parameter< bool >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type pivot(pivotSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type stratum(stratumSEXP);
+    Rcpp::traits::input_parameter< int >::type nstrata(nstrataSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(closeness_pivot_cpp(graph, alpha, out, distance, pivot, stratum, nstrata, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// graph_build_cpp
+SEXP graph_build_cpp(Rcpp::IntegerVector snode, Rcpp::IntegerVector tnode, Rcpp::NumericVector weight, int nnode, bool directed);
+RcppExport SEXP _wdnet_graph_build_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP weightSEXP, SEXP nnodeSEXP, SEXP directedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type snode(snodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type tnode(tnodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type nnode(nnodeSEXP);
+    Rcpp::traits::input_parameter< bool >::type directed(directedSEXP);
+    rcpp_result_gen = Rcpp::wrap(graph_build_cpp(snode, tnode, weight, nnode, directed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// graph_strength_cpp
+Rcpp::List graph_strength_cpp(SEXP graph);
+RcppExport SEXP _wdnet_graph_strength_cpp(SEXP graphSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    rcpp_result_gen = Rcpp::wrap(graph_strength_cpp(graph));
+    return rcpp_result_gen;
+END_RCPP
+}
+// graph_edges_cpp
+Rcpp::List graph_edges_cpp(SEXP graph);
+RcppExport SEXP _wdnet_graph_edges_cpp(SEXP graphSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    rcpp_result_gen = Rcpp::wrap(graph_edges_cpp(graph));
+    return rcpp_result_gen;
+END_RCPP
+}
+// graph_csc_cpp
+Rcpp::List graph_csc_cpp(SEXP graph, bool loops);
+RcppExport SEXP _wdnet_graph_csc_cpp(SEXP graphSEXP, SEXP loopsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< bool >::type loops(loopsSEXP);
+    rcpp_result_gen = Rcpp::wrap(graph_csc_cpp(graph, loops));
+    return rcpp_result_gen;
+END_RCPP
+}
 // hello_world
 void hello_world();
 RcppExport SEXP _wdnet_hello_world() {
@@ -33,9 +191,86 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// joint_dist_cpp
+Rcpp::List joint_dist_cpp(Rcpp::IntegerVector snode, Rcpp::IntegerVector tnode, int nnode, bool joint_dist);
+RcppExport SEXP _wdnet_joint_dist_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP nnodeSEXP, SEXP joint_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type snode(snodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type tnode(tnodeSEXP);
+    Rcpp::traits::input_parameter< int >::type nnode(nnodeSEXP);
+    Rcpp::traits::input_parameter< bool >::type joint_dist(joint_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(joint_dist_cpp(snode, tnode, nnode, joint_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// joint_dist_graph_cpp
+Rcpp::List joint_dist_graph_cpp(SEXP graph, bool joint_dist);
+RcppExport SEXP _wdnet_joint_dist_graph_cpp(SEXP graphSEXP, SEXP joint_distSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type graph(graphSEXP);
+    Rcpp::traits::input_parameter< bool >::type joint_dist(joint_distSEXP);
+    rcpp_result_gen = Rcpp::wrap(joint_dist_graph_cpp(graph, joint_dist));
+    return rcpp_result_gen;
+END_RCPP
+}
+// match_pair_cpp
+Rcpp::IntegerVector match_pair_cpp(Rcpp::IntegerVector x1, Rcpp::IntegerVector x2, Rcpp::IntegerVector table1, Rcpp::IntegerVector table2);
+RcppExport SEXP _wdnet_match_pair_cpp(SEXP x1SEXP, SEXP x2SEXP, SEXP table1SEXP, SEXP table2SEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type x1(x1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type x2(x2SEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type table1(table1SEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type table2(table2SEXP);
+    rcpp_result_gen = Rcpp::wrap(match_pair_cpp(x1, x2, table1, table2));
+    return rcpp_result_gen;
+END_RCPP
+}
+// solve_eta_cpp
+Rcpp::List solve_eta_cpp(arma::vec s, arma::vec t, arma::mat x, arma::mat y, std::vector<double> lower, std::vector<double> upper, double tol, int max_iter);
+RcppExport SEXP _wdnet_solve_eta_cpp(SEXP sSEXP, SEXP tSEXP, SEXP xSEXP, SEXP ySEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP tolSEXP, SEXP max_iterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::vec >::type s(sSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type t(tSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type x(xSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type max_iter(max_iterSEXP);
+    rcpp_result_gen = Rcpp::wrap(solve_eta_cpp(s, t, x, y, lower, upper, tol, max_iter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// solve_eta_grid_cpp
+Rcpp::List solve_eta_grid_cpp(arma::vec s, arma::vec t, arma::mat x, arma::mat y, arma::mat lower, arma::mat upper, double tol, int max_iter, int nthreads);
+RcppExport SEXP _wdnet_solve_eta_grid_cpp(SEXP sSEXP, SEXP tSEXP, SEXP xSEXP, SEXP ySEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP tolSEXP, SEXP max_iterSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::vec >::type s(sSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type t(tSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type x(xSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type y(ySEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type max_iter(max_iterSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(solve_eta_grid_cpp(s, t, x, y, lower, upper, tol, max_iter, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // dprewire_directed_cpp
-Rcpp::List dprewire_directed_cpp(int iteration, int nattempts, arma::uvec targetNode, arma::vec sourceOut, arma::vec sourceIn, arma::vec targetOut, arma::vec targetIn, arma::uvec index_s, arma::uvec index_t, arma::mat eta, bool rewire_history);
-RcppExport SEXP _wdnet_dprewire_directed_cpp(SEXP iterationSEXP, SEXP nattemptsSEXP, SEXP targetNodeSEXP, SEXP sourceOutSEXP, SEXP sourceInSEXP, SEXP targetOutSEXP, SEXP targetInSEXP, SEXP index_sSEXP, SEXP index_tSEXP, SEXP etaSEXP, SEXP rewire_historySEXP) {
+Rcpp::List dprewire_directed_cpp(int iteration, int nattempts, arma::uvec targetNode, arma::vec sourceOut, arma::vec sourceIn, arma::vec targetOut, arma::vec targetIn, arma::uvec index_s, arma::uvec index_t, arma::sp_mat eta, bool rewire_history, std::string history_file, int history_every, bool history_accepted, int nthreads);
+RcppExport SEXP _wdnet_dprewire_directed_cpp(SEXP iterationSEXP, SEXP nattemptsSEXP, SEXP targetNodeSEXP, SEXP sourceOutSEXP, SEXP sourceInSEXP, SEXP targetOutSEXP, SEXP targetInSEXP, SEXP index_sSEXP, SEXP index_tSEXP, SEXP etaSEXP, SEXP rewire_historySEXP, SEXP history_fileSEXP, SEXP history_everySEXP, SEXP history_acceptedSEXP, SEXP nthreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -48,15 +283,19 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< arma::vec >::type targetIn(targetInSEXP);
     Rcpp::traits::input_parameter< arma::uvec >::type index_s(index_sSEXP);
     Rcpp::traits::input_parameter< arma::uvec >::type index_t(index_tSEXP);
-    Rcpp::traits::input_parameter< arma::mat >::type eta(etaSEXP);
+    Rcpp::traits::input_parameter< arma::sp_mat >::type eta(etaSEXP);
     Rcpp::traits::input_parameter< bool >::type rewire_history(rewire_historySEXP);
-    rcpp_result_gen = Rcpp::wrap(dprewire_directed_cpp(iteration, nattempts, targetNode, sourceOut, sourceIn, targetOut, targetIn, index_s, index_t, eta, rewire_history));
+    Rcpp::traits::input_parameter< std::string >::type history_file(history_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type history_every(history_everySEXP);
+    Rcpp::traits::input_parameter< bool >::type history_accepted(history_acceptedSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(dprewire_directed_cpp(iteration, nattempts, targetNode, sourceOut, sourceIn, targetOut, targetIn, index_s, index_t, eta, rewire_history, history_file, history_every, history_accepted, nthreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // dprewire_undirected_cpp
-Rcpp::List dprewire_undirected_cpp(int iteration, int nattempts, Rcpp::IntegerVector node1, Rcpp::IntegerVector node2, arma::vec degree1, arma::vec degree2, arma::vec index1, arma::vec index2, arma::mat e, bool rewire_history);
-RcppExport SEXP _wdnet_dprewire_undirected_cpp(SEXP iterationSEXP, SEXP nattemptsSEXP, SEXP node1SEXP, SEXP node2SEXP, SEXP degree1SEXP, SEXP degree2SEXP, SEXP index1SEXP, SEXP index2SEXP, SEXP eSEXP, SEXP rewire_historySEXP) {
+Rcpp::List dprewire_undirected_cpp(int iteration, int nattempts, Rcpp::IntegerVector node1, Rcpp::IntegerVector node2, arma::vec degree1, arma::vec degree2, arma::vec index1, arma::vec index2, arma::sp_mat e, bool rewire_history, std::string history_file, int history_every, bool history_accepted, int nthreads);
+RcppExport SEXP _wdnet_dprewire_undirected_cpp(SEXP iterationSEXP, SEXP nattemptsSEXP, SEXP node1SEXP, SEXP node2SEXP, SEXP degree1SEXP, SEXP degree2SEXP, SEXP index1SEXP, SEXP index2SEXP, SEXP eSEXP, SEXP rewire_historySEXP, SEXP history_fileSEXP, SEXP history_everySEXP, SEXP history_acceptedSEXP, SEXP nthreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -68,33 +307,38 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< arma::vec >::type degree2(degree2SEXP);
     Rcpp::traits::input_parameter< arma::vec >::type index1(index1SEXP);
     Rcpp::traits::input_parameter< arma::vec >::type index2(index2SEXP);
-    Rcpp::traits::input_parameter< arma::mat >::type e(eSEXP);
+    Rcpp::traits::input_parameter< arma::sp_mat >::type e(eSEXP);
     Rcpp::traits::input_parameter< bool >::type rewire_history(rewire_historySEXP);
-    rcpp_result_gen = Rcpp::wrap(dprewire_undirected_cpp(iteration, nattempts, node1, node2, degree1, degree2, index1, index2, e, rewire_history));
+    Rcpp::traits::input_parameter< std::string >::type history_file(history_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type history_every(history_everySEXP);
+    Rcpp::traits::input_parameter< bool >::type history_accepted(history_acceptedSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(dprewire_undirected_cpp(iteration, nattempts, node1, node2, degree1, degree2, index1, index2, e, rewire_history, history_file, history_every, history_accepted, nthreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // rpanet_bag_cpp
-Rcpp::List rpanet_bag_cpp(arma::vec snode, arma::vec tnode, arma::vec scenario, int nnode, int nedge, double delta_out, double delta_in, bool directed);
-RcppExport SEXP _wdnet_rpanet_bag_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP scenarioSEXP, SEXP nnodeSEXP, SEXP nedgeSEXP, SEXP delta_outSEXP, SEXP delta_inSEXP, SEXP directedSEXP) {
+Rcpp::List rpanet_bag_cpp(arma::vec snode, arma::vec tnode, arma::vec scenario, Rcpp::IntegerVector m, int nnode, int nedge, double delta_out, double delta_in, bool directed);
+RcppExport SEXP _wdnet_rpanet_bag_cpp(SEXP snodeSEXP, SEXP tnodeSEXP, SEXP scenarioSEXP, SEXP mSEXP, SEXP nnodeSEXP, SEXP nedgeSEXP, SEXP delta_outSEXP, SEXP delta_inSEXP, SEXP directedSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< arma::vec >::type snode(snodeSEXP);
     Rcpp::traits::input_parameter< arma::vec >::type tnode(tnodeSEXP);
     Rcpp::traits::input_parameter< arma::vec >::type scenario(scenarioSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type m(mSEXP);
     Rcpp::traits::input_parameter< int >::type nnode(nnodeSEXP);
     Rcpp::traits::input_parameter< int >::type nedge(nedgeSEXP);
     Rcpp::traits::input_parameter< double >::type delta_out(delta_outSEXP);
     Rcpp::traits::input_parameter< double >::type delta_in(delta_inSEXP);
     Rcpp::traits::input_parameter< bool >::type directed(directedSEXP);
-    rcpp_result_gen = Rcpp::wrap(rpanet_bag_cpp(snode, tnode, scenario, nnode, nedge, delta_out, delta_in, directed));
+    rcpp_result_gen = Rcpp::wrap(rpanet_bag_cpp(snode, tnode, scenario, m, nnode, nedge, delta_out, delta_in, directed));
     return rcpp_result_gen;
 END_RCPP
 }
 // rpanet_binary_directed
-Rcpp::List rpanet_binary_directed(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerVector source_node, Rcpp::IntegerVector target_node, Rcpp::NumericVector outs, Rcpp::NumericVector ins, Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario, bool sample_recip, Rcpp::IntegerVector node_group, Rcpp::NumericVector source_pref, Rcpp::NumericVector target_pref, Rcpp::List control);
-RcppExport SEXP _wdnet_rpanet_binary_directed(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP source_nodeSEXP, SEXP target_nodeSEXP, SEXP outsSEXP, SEXP insSEXP, SEXP edgeweightSEXP, SEXP scenarioSEXP, SEXP sample_recipSEXP, SEXP node_groupSEXP, SEXP source_prefSEXP, SEXP target_prefSEXP, SEXP controlSEXP) {
+Rcpp::List rpanet_binary_directed(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerMatrix seed_edgelist, Rcpp::NumericVector outs, Rcpp::NumericVector ins, Rcpp::NumericVector edgeweight, bool store_edge, std::string edgelist_file, int assort_every, Rcpp::List checkpoint, bool sample_recip, Rcpp::IntegerVector node_group, Rcpp::NumericVector source_pref, Rcpp::NumericVector target_pref, Rcpp::List control);
+RcppExport SEXP _wdnet_rpanet_binary_directed(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP seed_edgelistSEXP, SEXP outsSEXP, SEXP insSEXP, SEXP edgeweightSEXP, SEXP store_edgeSEXP, SEXP edgelist_fileSEXP, SEXP assort_everySEXP, SEXP checkpointSEXP, SEXP sample_recipSEXP, SEXP node_groupSEXP, SEXP source_prefSEXP, SEXP target_prefSEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -102,24 +346,37 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type m(mSEXP);
     Rcpp::traits::input_parameter< int >::type new_node_id(new_node_idSEXP);
     Rcpp::traits::input_parameter< int >::type new_edge_id(new_edge_idSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type source_node(source_nodeSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type target_node(target_nodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type seed_edgelist(seed_edgelistSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type outs(outsSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type ins(insSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type edgeweight(edgeweightSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type scenario(scenarioSEXP);
+    Rcpp::traits::input_parameter< bool >::type store_edge(store_edgeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type edgelist_file(edgelist_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type assort_every(assort_everySEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type checkpoint(checkpointSEXP);
     Rcpp::traits::input_parameter< bool >::type sample_recip(sample_recipSEXP);
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_group(node_groupSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type source_pref(source_prefSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type target_pref(target_prefSEXP);
     Rcpp::traits::input_parameter< Rcpp::List >::type control(controlSEXP);
-    rcpp_result_gen = Rcpp::wrap(rpanet_binary_directed(nstep, m, new_node_id, new_edge_id, source_node, target_node, outs, ins, edgeweight, scenario, sample_recip, node_group, source_pref, target_pref, control));
+    rcpp_result_gen = Rcpp::wrap(rpanet_binary_directed(nstep, m, new_node_id, new_edge_id, seed_edgelist, outs, ins, edgeweight, store_edge, edgelist_file, assort_every, checkpoint, sample_recip, node_group, source_pref, target_pref, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rpanet_checkpoint_info_cpp
+Rcpp::List rpanet_checkpoint_info_cpp(std::string file);
+RcppExport SEXP _wdnet_rpanet_checkpoint_info_cpp(SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(rpanet_checkpoint_info_cpp(file));
     return rcpp_result_gen;
 END_RCPP
 }
 // rpanet_binary_undirected_cpp
-Rcpp::List rpanet_binary_undirected_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerVector node_vec1, Rcpp::IntegerVector node_vec2, Rcpp::NumericVector strength, Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario, Rcpp::NumericVector pref, Rcpp::List control);
-RcppExport SEXP _wdnet_rpanet_binary_undirected_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP node_vec1SEXP, SEXP node_vec2SEXP, SEXP strengthSEXP, SEXP edgeweightSEXP, SEXP scenarioSEXP, SEXP prefSEXP, SEXP controlSEXP) {
+Rcpp::List rpanet_binary_undirected_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerMatrix seed_edgelist, Rcpp::NumericVector strength, Rcpp::NumericVector edgeweight, bool store_edge, std::string edgelist_file, int assort_every, Rcpp::List checkpoint, Rcpp::NumericVector pref, Rcpp::List control);
+RcppExport SEXP _wdnet_rpanet_binary_undirected_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP seed_edgelistSEXP, SEXP strengthSEXP, SEXP edgeweightSEXP, SEXP store_edgeSEXP, SEXP edgelist_fileSEXP, SEXP assort_everySEXP, SEXP checkpointSEXP, SEXP prefSEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -127,20 +384,22 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type m(mSEXP);
     Rcpp::traits::input_parameter< int >::type new_node_id(new_node_idSEXP);
     Rcpp::traits::input_parameter< int >::type new_edge_id(new_edge_idSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_vec1(node_vec1SEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_vec2(node_vec2SEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type seed_edgelist(seed_edgelistSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type strength(strengthSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type edgeweight(edgeweightSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type scenario(scenarioSEXP);
+    Rcpp::traits::input_parameter< bool >::type store_edge(store_edgeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type edgelist_file(edgelist_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type assort_every(assort_everySEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type checkpoint(checkpointSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type pref(prefSEXP);
     Rcpp::traits::input_parameter< Rcpp::List >::type control(controlSEXP);
-    rcpp_result_gen = Rcpp::wrap(rpanet_binary_undirected_cpp(nstep, m, new_node_id, new_edge_id, node_vec1, node_vec2, strength, edgeweight, scenario, pref, control));
+    rcpp_result_gen = Rcpp::wrap(rpanet_binary_undirected_cpp(nstep, m, new_node_id, new_edge_id, seed_edgelist, strength, edgeweight, store_edge, edgelist_file, assort_every, checkpoint, pref, control));
     return rcpp_result_gen;
 END_RCPP
 }
 // rpanet_linear_directed_cpp
-Rcpp::List rpanet_linear_directed_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerVector source_node, Rcpp::IntegerVector target_node, Rcpp::NumericVector outs, Rcpp::NumericVector ins, Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario, bool sample_recip, Rcpp::IntegerVector node_group, Rcpp::NumericVector source_pref_vec, Rcpp::NumericVector target_pref_vec, Rcpp::List control);
-RcppExport SEXP _wdnet_rpanet_linear_directed_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP source_nodeSEXP, SEXP target_nodeSEXP, SEXP outsSEXP, SEXP insSEXP, SEXP edgeweightSEXP, SEXP scenarioSEXP, SEXP sample_recipSEXP, SEXP node_groupSEXP, SEXP source_pref_vecSEXP, SEXP target_pref_vecSEXP, SEXP controlSEXP) {
+Rcpp::List rpanet_linear_directed_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerMatrix seed_edgelist, Rcpp::NumericVector outs, Rcpp::NumericVector ins, Rcpp::NumericVector edgeweight, bool store_edge, std::string edgelist_file, int assort_every, Rcpp::List checkpoint, bool sample_recip, Rcpp::IntegerVector node_group, Rcpp::NumericVector source_pref_vec, Rcpp::NumericVector target_pref_vec, Rcpp::List control);
+RcppExport SEXP _wdnet_rpanet_linear_directed_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP seed_edgelistSEXP, SEXP outsSEXP, SEXP insSEXP, SEXP edgeweightSEXP, SEXP store_edgeSEXP, SEXP edgelist_fileSEXP, SEXP assort_everySEXP, SEXP checkpointSEXP, SEXP sample_recipSEXP, SEXP node_groupSEXP, SEXP source_pref_vecSEXP, SEXP target_pref_vecSEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -148,24 +407,26 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type m(mSEXP);
     Rcpp::traits::input_parameter< int >::type new_node_id(new_node_idSEXP);
     Rcpp::traits::input_parameter< int >::type new_edge_id(new_edge_idSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type source_node(source_nodeSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type target_node(target_nodeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type seed_edgelist(seed_edgelistSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type outs(outsSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type ins(insSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type edgeweight(edgeweightSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type scenario(scenarioSEXP);
+    Rcpp::traits::input_parameter< bool >::type store_edge(store_edgeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type edgelist_file(edgelist_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type assort_every(assort_everySEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type checkpoint(checkpointSEXP);
     Rcpp::traits::input_parameter< bool >::type sample_recip(sample_recipSEXP);
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_group(node_groupSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type source_pref_vec(source_pref_vecSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type target_pref_vec(target_pref_vecSEXP);
     Rcpp::traits::input_parameter< Rcpp::List >::type control(controlSEXP);
-    rcpp_result_gen = Rcpp::wrap(rpanet_linear_directed_cpp(nstep, m, new_node_id, new_edge_id, source_node, target_node, outs, ins, edgeweight, scenario, sample_recip, node_group, source_pref_vec, target_pref_vec, control));
+    rcpp_result_gen = Rcpp::wrap(rpanet_linear_directed_cpp(nstep, m, new_node_id, new_edge_id, seed_edgelist, outs, ins, edgeweight, store_edge, edgelist_file, assort_every, checkpoint, sample_recip, node_group, source_pref_vec, target_pref_vec, control));
     return rcpp_result_gen;
 END_RCPP
 }
 // rpanet_linear_undirected_cpp
-Rcpp::List rpanet_linear_undirected_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerVector node_vec1, Rcpp::IntegerVector node_vec2, Rcpp::NumericVector strength, Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario, Rcpp::NumericVector pref_vec, Rcpp::List control);
-RcppExport SEXP _wdnet_rpanet_linear_undirected_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP node_vec1SEXP, SEXP node_vec2SEXP, SEXP strengthSEXP, SEXP edgeweightSEXP, SEXP scenarioSEXP, SEXP pref_vecSEXP, SEXP controlSEXP) {
+Rcpp::List rpanet_linear_undirected_cpp(int nstep, Rcpp::IntegerVector m, int new_node_id, int new_edge_id, Rcpp::IntegerMatrix seed_edgelist, Rcpp::NumericVector strength, Rcpp::NumericVector edgeweight, bool store_edge, std::string edgelist_file, int assort_every, Rcpp::List checkpoint, Rcpp::NumericVector pref_vec, Rcpp::List control);
+RcppExport SEXP _wdnet_rpanet_linear_undirected_cpp(SEXP nstepSEXP, SEXP mSEXP, SEXP new_node_idSEXP, SEXP new_edge_idSEXP, SEXP seed_edgelistSEXP, SEXP strengthSEXP, SEXP edgeweightSEXP, SEXP store_edgeSEXP, SEXP edgelist_fileSEXP, SEXP assort_everySEXP, SEXP checkpointSEXP, SEXP pref_vecSEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -173,14 +434,16 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type m(mSEXP);
     Rcpp::traits::input_parameter< int >::type new_node_id(new_node_idSEXP);
     Rcpp::traits::input_parameter< int >::type new_edge_id(new_edge_idSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_vec1(node_vec1SEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type node_vec2(node_vec2SEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerMatrix >::type seed_edgelist(seed_edgelistSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type strength(strengthSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type edgeweight(edgeweightSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type scenario(scenarioSEXP);
+    Rcpp::traits::input_parameter< bool >::type store_edge(store_edgeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type edgelist_file(edgelist_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type assort_every(assort_everySEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type checkpoint(checkpointSEXP);
     Rcpp::traits::input_parameter< Rcpp::NumericVector >::type pref_vec(pref_vecSEXP);
     Rcpp::traits::input_parameter< Rcpp::List >::type control(controlSEXP);
-    rcpp_result_gen = Rcpp::wrap(rpanet_linear_undirected_cpp(nstep, m, new_node_id, new_edge_id, node_vec1, node_vec2, strength, edgeweight, scenario, pref_vec, control));
+    rcpp_result_gen = Rcpp::wrap(rpanet_linear_undirected_cpp(nstep, m, new_node_id, new_edge_id, seed_edgelist, strength, edgeweight, store_edge, edgelist_file, assort_every, checkpoint, pref_vec, control));
     return rcpp_result_gen;
 END_RCPP
 }
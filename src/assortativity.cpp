@@ -0,0 +1,326 @@
+#include <RcppArmadillo.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "assortativity.h"
+#include "file_closer.h"
+#include "graph.h"
+// [[Rcpp::depends(RcppArmadillo)]]
+
+// Number of edges read from an edgelist file at a time.
+static const int FILE_BLOCK = 1 << 20;
+
+// Aggregate edgeweight into out- and in-strength. Returns the number of
+// edges with a node index outside of [1, nnode].
+static int addStrength(const int *snode, const int *tnode,
+                       const double *weight, int n, int nnode,
+                       double *outs, double *ins, int nthreads) {
+  int bad = 0;
+  #pragma omp parallel for num_threads(nthreads) reduction(+:bad) schedule(static)
+  for (int i = 0; i < n; i++) {
+    if (snode[i] < 1 || snode[i] > nnode || tnode[i] < 1 || tnode[i] > nnode) {
+      bad++;
+      continue;
+    }
+    #pragma omp atomic
+    outs[snode[i] - 1] += weight[i];
+    #pragma omp atomic
+    ins[tnode[i] - 1] += weight[i];
+  }
+  return bad;
+}
+
+// Accumulate the moments of edges [from, to) into m, which holds the
+// "outout", "outin", "inout" and "inin" moments if directed, otherwise the
+// undirected one. The strength of an undirected node counts both ends of its
+// edges, each undirected edge is added in both directions.
+static void addMoments(const int *snode, const int *tnode,
+                       const double *weight, int from, int to,
+                       const double *outs, const double *ins, bool directed,
+                       assort_moments *m) {
+  for (int i = from; i < to; i++) {
+    addEdgeMoments(outs[snode[i] - 1], ins[snode[i] - 1], outs[tnode[i] - 1],
+                   ins[tnode[i] - 1], weight[i], directed, m);
+  }
+}
+
+// Split n edges into one contiguous chunk per thread and append the moments
+// of each chunk to chunk.
+static void chunkMoments(const int *snode, const int *tnode,
+                         const double *weight, int n,
+                         const double *outs, const double *ins,
+                         bool directed, int nthreads,
+                         std::vector<assort_moments> &chunk) {
+  int ntype = directed ? 4 : 1;
+  int nchunk = std::max(1, std::min(nthreads, n / 1024));
+  size_t base = chunk.size();
+  chunk.resize(base + (size_t) nchunk * ntype);
+  #pragma omp parallel for num_threads(nthreads) schedule(static, 1)
+  for (int c = 0; c < nchunk; c++) {
+    int from = (int) ((int64_t) n * c / nchunk);
+    int to = (int) ((int64_t) n * (c + 1) / nchunk);
+    addMoments(snode, tnode, weight, from, to, outs, ins, directed,
+               &chunk[base + (size_t) c * ntype]);
+  }
+}
+
+// Merge the chunk moments of each type pairwise, i.e., neighbouring chunks
+// first, so that the merged moments have similar weights. The merged moments
+// are left in the first ntype elements of chunk.
+static void mergeChunks(std::vector<assort_moments> &chunk, size_t ntype) {
+  size_t nchunk = chunk.size() / ntype;
+  for (size_t step = 1; step < nchunk; step *= 2) {
+    for (size_t c = 0; c + step < nchunk; c += 2 * step) {
+      for (size_t k = 0; k < ntype; k++) {
+        chunk[c * ntype + k].merge(chunk[(c + step) * ntype + k]);
+      }
+    }
+  }
+  if (nchunk == 0) {
+    chunk.resize(ntype);
+  }
+}
+
+// Degree based assortativity coefficients from the chunk moments.
+static SEXP reduceMoments(std::vector<assort_moments> &chunk, bool directed) {
+  mergeChunks(chunk, directed ? 4 : 1);
+  if (! directed) {
+    return Rcpp::wrap(chunk[0].cor());
+  }
+  return Rcpp::List::create(Rcpp::Named("outout") = chunk[0].cor(),
+                            Rcpp::Named("outin") = chunk[1].cor(),
+                            Rcpp::Named("inout") = chunk[2].cor(),
+                            Rcpp::Named("inin") = chunk[3].cor());
+}
+
+//' Degree based assortativity coefficients from an edgelist.
+//'
+//' Node strengths are aggregated from the edges, then the four directed
+//' coefficients (or the undirected one) are accumulated in a single pass over
+//' the edges. For undirected networks, each edge is counted in both
+//' directions. With more than one thread, the edges are split into
+//' contiguous chunks and the moments of the chunks are merged pairwise.
+//'
+//' @param snode Source nodes.
+//' @param tnode Target nodes.
+//' @param weight Edgeweight.
+//' @param nnode Number of nodes.
+//' @param directed Logical, whether the network is directed.
+//' @param nthreads Number of threads.
+//' @return A list of "outout", "outin", "inout" and "inin" assortativity
+//'   coefficients if the network is directed, otherwise the assortativity
+//'   coefficient.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+SEXP assortcoef_cpp(Rcpp::IntegerVector snode,
+                    Rcpp::IntegerVector tnode,
+                    Rcpp::NumericVector weight,
+                    int nnode,
+                    bool directed,
+                    int nthreads = 1) {
+  int n = snode.size();
+  std::vector<double> outs(nnode, 0.0), ins(nnode, 0.0);
+  if (addStrength(snode.begin(), tnode.begin(), weight.begin(), n, nnode,
+                  outs.data(), ins.data(), nthreads) > 0) {
+    Rcpp::stop("Node index out of range.");
+  }
+  std::vector<assort_moments> chunk;
+  chunkMoments(snode.begin(), tnode.begin(), weight.begin(), n,
+               outs.data(), ins.data(), directed, nthreads, chunk);
+  return reduceMoments(chunk, directed);
+}
+
+//' Degree based assortativity coefficients of a graph.
+//'
+//' Same as \code{assortcoef_cpp}, with the strengths cached in the graph.
+//'
+//' @param graph An external pointer to the graph.
+//' @param nthreads Number of threads.
+//' @return See \code{assortcoef_cpp}.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+SEXP assortcoef_graph_cpp(SEXP graph, int nthreads = 1) {
+  wdnet_graph &net = graphFromXPtr(graph);
+  std::vector<assort_moments> chunk;
+  chunkMoments(net.snode.data(), net.tnode.data(), net.weight.data(),
+               net.snode.size(), net.outs.data(), net.ins.data(),
+               net.directed, nthreads, chunk);
+  return reduceMoments(chunk, net.directed);
+}
+
+// Read the next n records and weights of an edgelist file into snode,
+// tnode and weight. Returns false if the file ends early.
+static bool readEdgeBlock(FILE *fr, FILE *fw, int n, std::vector<int> &record,
+                          int *snode, int *tnode, double *weight) {
+  if (fread(record.data(), sizeof(int), 3 * (size_t) n, fr) != 3 * (size_t) n ||
+      fread(weight, sizeof(double), n, fw) != (size_t) n) {
+    return false;
+  }
+  for (int i = 0; i < n; i++) {
+    snode[i] = record[3 * i];
+    tnode[i] = record[3 * i + 1];
+  }
+  return true;
+}
+
+//' Degree based assortativity coefficients from an edgelist file.
+//'
+//' Same as \code{assortcoef_cpp}, for an edgelist file written by
+//' \code{rpanet}. The file is read twice in blocks, first for the node
+//' strengths and then for the moments, so that only the node strengths and
+//' one block of edges are held in memory.
+//'
+//' @param file An edgelist file written by \code{rpanet}.
+//' @param nthreads Number of threads.
+//' @return A list of "directed" and "assortcoef", the latter is the same as
+//'   the return value of \code{assortcoef_cpp}.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List assortcoef_file_cpp(std::string file, int nthreads = 1) {
+  char magic[8];
+  int header[2];
+  int64_t nedge;
+  FILE *fr = fopen(file.c_str(), "rb");
+  file_closer close_fr(fr);
+  if (fr == NULL) {
+    Rcpp::stop("Cannot open the edgelist file.");
+  }
+  if (fread(magic, 1, 8, fr) != 8 || memcmp(magic, "WDNETEDG", 8) != 0 ||
+      fread(header, sizeof(int), 2, fr) != 2 ||
+      fread(&nedge, sizeof(int64_t), 1, fr) != 1 || nedge < 0) {
+    Rcpp::stop("Not an edgelist file written by rpanet.");
+  }
+  if (header[0] != 1) {
+    Rcpp::stop("Unsupported edgelist file version.");
+  }
+  bool directed = header[1] == 1;
+  FILE *fw = fopen(file.c_str(), "rb");
+  file_closer close_fw(fw);
+  int64_t weight_offset = 24 + 12 * nedge;
+  std::vector<int> record(3 * (size_t) FILE_BLOCK), snode(FILE_BLOCK),
+    tnode(FILE_BLOCK);
+  std::vector<double> weight(FILE_BLOCK), outs, ins;
+  std::vector<assort_moments> chunk;
+  bool ok = fw != NULL;
+  for (int pass = 0; pass < 2 && ok; pass++) {
+    ok = seekFile(fr, 24) == 0 && seekFile(fw, weight_offset) == 0;
+    for (int64_t from = 0; from < nedge && ok; from += FILE_BLOCK) {
+      int n = (int) std::min((int64_t) FILE_BLOCK, nedge - from);
+      ok = readEdgeBlock(fr, fw, n, record, snode.data(), tnode.data(),
+                         weight.data());
+      if (! ok) {
+        break;
+      }
+      if (pass == 0) {
+        // nodes are numbered in order of appearance, grow the strengths
+        int nnode = (int) outs.size();
+        for (int i = 0; i < n; i++) {
+          nnode = std::max(nnode, std::max(snode[i], tnode[i]));
+        }
+        outs.resize(nnode, 0.0);
+        ins.resize(nnode, 0.0);
+        ok = addStrength(snode.data(), tnode.data(), weight.data(), n, nnode,
+                         outs.data(), ins.data(), nthreads) == 0;
+      } else {
+        chunkMoments(snode.data(), tnode.data(), weight.data(), n,
+                     outs.data(), ins.data(), directed, nthreads, chunk);
+      }
+      Rcpp::checkUserInterrupt();
+    }
+  }
+  if (! ok) {
+    Rcpp::stop("Failed to read the edgelist file.");
+  }
+  return Rcpp::List::create(Rcpp::Named("directed") = directed,
+                            Rcpp::Named("assortcoef") =
+                              reduceMoments(chunk, directed));
+}
+
+//' Feature based assortativity coefficients from an edgelist.
+//'
+//' Coefficients of many pairs of node features are accumulated in one pass
+//' over the edges. The features are transposed first, so that the features
+//' of a node are contiguous in memory.
+//'
+//' @param snode Source nodes.
+//' @param tnode Target nodes.
+//' @param weight Edgeweight.
+//' @param feature A matrix of node features, one row for each node.
+//' @param pair A two column matrix, each row gives the columns (starts from
+//'   1) of \code{feature} of the source and target nodes of a coefficient.
+//' @param directed Logical, whether the network is directed. If not, each
+//'   edge is counted in both directions.
+//' @param nthreads Number of threads.
+//' @return Assortativity coefficients, one for each row of \code{pair}.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::NumericVector feature_assort_cpp(Rcpp::IntegerVector snode,
+                                       Rcpp::IntegerVector tnode,
+                                       Rcpp::NumericVector weight,
+                                       Rcpp::NumericMatrix feature,
+                                       Rcpp::IntegerMatrix pair,
+                                       bool directed,
+                                       int nthreads = 1) {
+  int n = snode.size(), nnode = feature.nrow(), nfeature = feature.ncol();
+  int npair = pair.nrow();
+  if (npair == 0) {
+    return Rcpp::NumericVector(0);
+  }
+  std::vector<int> fs(npair), ft(npair);
+  for (int k = 0; k < npair; k++) {
+    fs[k] = pair(k, 0) - 1;
+    ft[k] = pair(k, 1) - 1;
+    if (fs[k] < 0 || fs[k] >= nfeature || ft[k] < 0 || ft[k] >= nfeature) {
+      Rcpp::stop("Feature index out of range.");
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    if (snode[i] < 1 || snode[i] > nnode || tnode[i] < 1 || tnode[i] > nnode) {
+      Rcpp::stop("Node index out of range.");
+    }
+  }
+  std::vector<double> f((size_t) nnode * nfeature);
+  for (int j = 0; j < nfeature; j++) {
+    for (int i = 0; i < nnode; i++) {
+      f[(size_t) i * nfeature + j] = feature(i, j);
+    }
+  }
+
+  const int *s = snode.begin(), *t = tnode.begin();
+  const double *w = weight.begin();
+  int nchunk = std::max(1, std::min(nthreads, n / 1024));
+  std::vector<assort_moments> chunk((size_t) nchunk * npair);
+  #pragma omp parallel for num_threads(nthreads) schedule(static, 1)
+  for (int c = 0; c < nchunk; c++) {
+    int from = (int) ((int64_t) n * c / nchunk);
+    int to = (int) ((int64_t) n * (c + 1) / nchunk);
+    assort_moments *m = &chunk[(size_t) c * npair];
+    for (int i = from; i < to; i++) {
+      const double *x = &f[(size_t) (s[i] - 1) * nfeature];
+      const double *y = &f[(size_t) (t[i] - 1) * nfeature];
+      for (int k = 0; k < npair; k++) {
+        m[k].add(x[fs[k]], y[ft[k]], w[i]);
+        if (! directed) {
+          m[k].add(y[fs[k]], x[ft[k]], w[i]);
+        }
+      }
+    }
+  }
+  mergeChunks(chunk, npair);
+  Rcpp::NumericVector ret(npair);
+  for (int k = 0; k < npair; k++) {
+    ret[k] = chunk[k].cor();
+  }
+  return ret;
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <Rcpp.h>
+
+// Weighted first and second moments of (x, y) pairs, accumulated in one
+// pass with West's (1979) updates, so that the centered sums do not suffer
+// from cancellation when the strengths are large. Moments of disjoint sets
+// of pairs can be merged, which allows chunks of edges to be processed in
+// parallel.
+struct assort_moments {
+  double w, mx, my, sxx, syy, sxy;
+
+  assort_moments() : w(0), mx(0), my(0), sxx(0), syy(0), sxy(0) {}
+
+  inline void add(double x, double y, double weight) {
+    if (weight == 0) {
+      return;
+    }
+    w += weight;
+    double dx = x - mx, dy = y - my;
+    mx += dx * weight / w;
+    my += dy * weight / w;
+    sxx += weight * dx * (x - mx);
+    syy += weight * dy * (y - my);
+    sxy += weight * dx * (y - my);
+  }
+
+  // Combine with the moments of another set of pairs, Chan et al. (1979).
+  inline void merge(const assort_moments &o) {
+    if (o.w == 0) {
+      return;
+    }
+    if (w == 0) {
+      *this = o;
+      return;
+    }
+    double total = w + o.w, dx = o.mx - mx, dy = o.my - my;
+    double f = w * o.w / total;
+    sxx += o.sxx + dx * dx * f;
+    syy += o.syy + dy * dy * f;
+    sxy += o.sxy + dx * dy * f;
+    mx += dx * o.w / total;
+    my += dy * o.w / total;
+    w = total;
+  }
+
+  // Weighted Pearson correlation of the pairs added so far.
+  inline double cor() const {
+    return sxy / sqrt(sxx * syy);
+  }
+};
+
+// Add an edge, with strengths (so, si) of its source and (to, ti) of its
+// target, to the "outout", "outin", "inout" and "inin" moments in m if
+// directed, otherwise to the undirected one in m[0], in both directions.
+inline void addEdgeMoments(double so, double si, double to, double ti,
+                           double w, bool directed, assort_moments *m) {
+  if (directed) {
+    m[0].add(so, to, w);
+    m[1].add(so, ti, w);
+    m[2].add(si, to, w);
+    m[3].add(si, ti, w);
+  } else {
+    m[0].add(so + si, to + ti, w);
+    m[0].add(to + ti, so + si, w);
+  }
+}
+
+// Assortativity coefficients of a growing network, recorded at given steps
+// of a simulation. The coefficients are kept exact with running sums as the
+// edges are added. With x the strength of the source and y the strength of
+// the target of an edge, the sums of w, w * x, w * x^2, w * y and w * y^2
+// over the edges are sums over the nodes of polynomials in their strengths,
+// e.g., the sum of w * outs(source) is the sum of outs^2 over the nodes, so
+// they are updated in O(1) when the strengths of a node change. The cross
+// sums of w * x * y change by the strength change times the sum of w * y
+// (or w * x) over the edges of the node, so they are updated in time linear
+// in the degrees of the end nodes of the new edge. Long double accumulators
+// limit the cancellation when the strengths are large.
+struct assort_monitor {
+  bool directed;
+  // end nodes (node ids start from 1) and weights of the edges, owned by the
+  // driver; the end nodes are kept in own_source and own_target if the
+  // driver does not store them
+  const int *source, *target;
+  const double *weight;
+  std::vector<int> own_source, own_target;
+  // edges of each node as linked lists of edge ids, -1 terminated
+  std::vector<int> head_out, head_in, next_out, next_in;
+  std::vector<double> outs, ins;
+  // sums over the nodes of o, o^2, o * i, i^2, o^3, o^2 * i, o * i^2 and
+  // i^3 with o and i the out- and in-strength if directed, otherwise of s,
+  // s^2 and s^3 with s = o + i
+  long double node_sum[8];
+  // sums of w * x * y for "outout", "outin", "inout" and "inin", or the
+  // undirected one counting each edge in both directions
+  long double cross_sum[4];
+  std::vector<int> step;
+  std::vector<double> value;
+
+  // source and target are NULL if the driver does not store the edges.
+  assort_monitor(bool directed, const int *source, const int *target,
+                 const double *weight)
+    : directed(directed), source(source), target(target), weight(weight) {
+    std::fill(node_sum, node_sum + 8, 0.0L);
+    std::fill(cross_sum, cross_sum + 4, 0.0L);
+  }
+
+  inline int sourceOf(int e) const {
+    return (source != NULL ? source[e] : own_source[e]) - 1;
+  }
+
+  inline int targetOf(int e) const {
+    return (target != NULL ? target[e] : own_target[e]) - 1;
+  }
+
+  // Add (sign = 1) or remove (sign = -1) the polynomials of node z.
+  inline void nodeSum(int z, double sign) {
+    long double o = outs[z], i = ins[z];
+    if (directed) {
+      long double p[8] = {o, o * o, o * i, i * i, o * o * o, o * o * i,
+                          o * i * i, i * i * i};
+      for (int k = 0; k < 8; k++) {
+        node_sum[k] += sign * p[k];
+      }
+    } else {
+      long double t = o + i;
+      node_sum[0] += sign * t;
+      node_sum[1] += sign * t * t;
+      node_sum[2] += sign * t * t * t;
+    }
+  }
+
+  // Change the out-strength (c = 0) or the in-strength (c = 1) of node z by
+  // d, with the running sums of the current edges.
+  inline void shift(int z, int c, double d) {
+    // sums of w * outs and w * ins of the other end over the out-edges
+    // (nbr_out) and in-edges (nbr_in) of z, and the weight of self-loops
+    long double nbr_out[2] = {0, 0}, nbr_in[2] = {0, 0}, loop = 0;
+    for (int e = head_out[z]; e >= 0; e = next_out[e]) {
+      int t = targetOf(e);
+      nbr_out[0] += weight[e] * (long double) outs[t];
+      nbr_out[1] += weight[e] * (long double) ins[t];
+      if (t == z) {
+        loop += weight[e];
+      }
+    }
+    for (int e = head_in[z]; e >= 0; e = next_in[e]) {
+      int s = sourceOf(e);
+      nbr_in[0] += weight[e] * (long double) outs[s];
+      nbr_in[1] += weight[e] * (long double) ins[s];
+    }
+    if (directed) {
+      // x of the out-edges of z and y of its in-edges change
+      for (int a = 0; a < 2; a++) {
+        for (int b = 0; b < 2; b++) {
+          long double delta = 0;
+          if (a == c) {
+            delta += d * nbr_out[b];
+          }
+          if (b == c) {
+            delta += d * nbr_in[a];
+          }
+          if (a == c && b == c) {
+            delta += (long double) d * d * loop;
+          }
+          cross_sum[2 * a + b] += delta;
+        }
+      }
+    } else {
+      // the strength is o + i, each edge is counted in both directions
+      cross_sum[0] += 2 * d * (nbr_out[0] + nbr_out[1] + nbr_in[0] +
+                               nbr_in[1]) + 2 * (long double) d * d * loop;
+    }
+    nodeSum(z, -1);
+    (c == 0 ? outs[z] : ins[z]) += d;
+    nodeSum(z, 1);
+  }
+
+  // Add edge e from source to target, node ids start from 0. The end nodes
+  // of e must have been stored by the driver if it stores the edges.
+  inline void addEdge(int e, int s, int t) {
+    size_t n = (size_t) std::max(s, t) + 1;
+    if (n > outs.size()) {
+      n = std::max(n, 2 * outs.size());
+      outs.resize(n, 0.0);
+      ins.resize(n, 0.0);
+      head_out.resize(n, -1);
+      head_in.resize(n, -1);
+    }
+    if (source == NULL) {
+      own_source.push_back(s + 1);
+      own_target.push_back(t + 1);
+    }
+    double w = weight[e];
+    shift(s, 0, w);
+    shift(t, 1, w);
+    // the new edge, with the updated strengths
+    if (directed) {
+      long double x[2] = {outs[s], ins[s]}, y[2] = {outs[t], ins[t]};
+      for (int a = 0; a < 2; a++) {
+        for (int b = 0; b < 2; b++) {
+          cross_sum[2 * a + b] += w * x[a] * y[b];
+        }
+      }
+    } else {
+      cross_sum[0] += 2 * w * ((long double) outs[s] + ins[s]) *
+        ((long double) outs[t] + ins[t]);
+    }
+    next_out.push_back(head_out[s]);
+    head_out[s] = e;
+    next_in.push_back(head_in[t]);
+    head_in[t] = e;
+  }
+
+  // Record the coefficients of the current network at step k.
+  inline void record(int k) {
+    step.push_back(k);
+    if (! directed) {
+      long double w = node_sum[0], sx = node_sum[1], sxx = node_sum[2];
+      long double var = sxx - sx * sx / w;
+      value.push_back((double) ((cross_sum[0] - sx * sx / w) / var));
+      return;
+    }
+    // sums of w * x and w * x^2 for x = outs and ins of the source, and of
+    // w * y and w * y^2 for y = outs and ins of the target
+    long double w = node_sum[0];
+    long double sx[2] = {node_sum[1], node_sum[2]};
+    long double sxx[2] = {node_sum[4], node_sum[6]};
+    long double sy[2] = {node_sum[2], node_sum[3]};
+    long double syy[2] = {node_sum[5], node_sum[7]};
+    for (int a = 0; a < 2; a++) {
+      for (int b = 0; b < 2; b++) {
+        long double cov = cross_sum[2 * a + b] - sx[a] * sy[b] / w;
+        long double var = (sxx[a] - sx[a] * sx[a] / w) *
+          (syy[b] - sy[b] * sy[b] / w);
+        value.push_back((double) (cov / sqrtl(var)));
+      }
+    }
+  }
+
+  // A matrix of the step and the coefficients ("outout", "outin",
+  // "inout" and "inin" if directed), one row for each record.
+  inline Rcpp::NumericMatrix result() const {
+    int ntype = directed ? 4 : 1, nrec = (int) step.size();
+    Rcpp::NumericMatrix ret(nrec, ntype + 1);
+    for (int r = 0; r < nrec; r++) {
+      ret(r, 0) = step[r];
+      for (int j = 0; j < ntype; j++) {
+        ret(r, j + 1) = value[(size_t) r * ntype + j];
+      }
+    }
+    return ret;
+  }
+};
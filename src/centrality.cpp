@@ -0,0 +1,533 @@
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "graph.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::depends(RcppArmadillo)]]
+
+// Transition matrix of the weighted PageRank, stored by compressed columns of
+// the adjacency matrix, i.e., the in-edges of each node, so that a matrix
+// vector product pulls scores from the source nodes. Parallel edges are
+// merged. For the edge from node i, a is its weight divided by the
+// out-strength of i and b is one divided by the out-degree of i, the
+// transition probability is theta * a + (1 - theta) * b.
+struct wpr_matrix {
+  int nnode;
+  std::vector<int> ptr, source;
+  std::vector<double> a, b;
+  std::vector<int> sink;
+};
+
+// Build the transition matrix from the in-edges of the nodes.
+static void buildWprMatrix(const csr_graph &in, wpr_matrix &m) {
+  int nnode = in.nnode, k = in.ptr[nnode];
+  std::vector<double> outs(nnode, 0.0), outd(nnode, 0.0);
+  for (int e = 0; e < k; e++) {
+    outs[in.nbr[e]] += in.weight[e];
+    outd[in.nbr[e]] += 1;
+  }
+  m.nnode = nnode;
+  m.ptr = in.ptr;
+  m.source = in.nbr;
+  m.a.resize(k);
+  m.b.resize(k);
+  for (int e = 0; e < k; e++) {
+    m.a[e] = in.weight[e] / outs[m.source[e]];
+    m.b[e] = 1 / outd[m.source[e]];
+  }
+  m.sink.clear();
+  for (int i = 0; i < nnode; i++) {
+    if (outd[i] == 0) {
+      m.sink.push_back(i);
+    }
+  }
+}
+
+// Quadratic extrapolation (Kamvar et al., 2003) from four successive
+// iterates x0, x1, x2 and x3, the result is stored in x3. The extrapolation
+// is skipped if it gives a non-positive score.
+static void quadraticExtrapolate(const std::vector<double> &x0,
+                                 const std::vector<double> &x1,
+                                 const std::vector<double> &x2,
+                                 std::vector<double> &x3, int nthreads) {
+  int n = x3.size();
+  // least squares fit of x3 - x0 by x1 - x0 and x2 - x0
+  double a11 = 0, a12 = 0, a22 = 0, b1 = 0, b2 = 0;
+  #pragma omp parallel for num_threads(nthreads) reduction(+:a11,a12,a22,b1,b2) schedule(static)
+  for (int j = 0; j < n; j++) {
+    double y1 = x1[j] - x0[j], y2 = x2[j] - x0[j], y3 = x3[j] - x0[j];
+    a11 += y1 * y1;
+    a12 += y1 * y2;
+    a22 += y2 * y2;
+    b1 += y1 * y3;
+    b2 += y2 * y3;
+  }
+  double det = a11 * a22 - a12 * a12;
+  if (! (fabs(det) > 0)) {
+    return;
+  }
+  double g1 = -(a22 * b1 - a12 * b2) / det, g2 = -(a11 * b2 - a12 * b1) / det;
+  double c1 = g1 + g2 + 1, c2 = g2 + 1, total = 0;
+  int negative = 0;
+  #pragma omp parallel for num_threads(nthreads) reduction(+:total,negative) schedule(static)
+  for (int j = 0; j < n; j++) {
+    double z = c1 * x1[j] + c2 * x2[j] + x3[j];
+    negative += z <= 0;
+    total += z;
+  }
+  if (negative > 0) {
+    return;
+  }
+  #pragma omp parallel for num_threads(nthreads) schedule(static)
+  for (int j = 0; j < n; j++) {
+    x3[j] = (c1 * x1[j] + c2 * x2[j] + x3[j]) / total;
+  }
+}
+
+// Power iteration of the weighted PageRank starting from x. The scores of
+// sink nodes and the teleportation are redistributed by prior, without
+// forming the dense matrix. The rows of the matrix vector product are split
+// among threads. If extrapolate is positive, quadratic extrapolation is
+// applied every extrapolate iterations. Returns the number of iterations, the L1
+// change of the last iteration is stored in change.
+static int wprIterate(const wpr_matrix &m, double gamma, double theta,
+                      const std::vector<double> &prior, double tol,
+                      int max_iter, int nthreads, int extrapolate,
+                      std::vector<double> &x, double *change) {
+  int n = m.nnode, iter;
+  std::vector<double> y(n), x0(extrapolate > 0 ? n : 0), x1(x0.size());
+  double total, sink_mass, restart, diff = INFINITY;
+  for (iter = 1; iter <= max_iter; iter++) {
+    total = 0;
+    for (int i = 0; i < n; i++) {
+      total += x[i];
+    }
+    sink_mass = 0;
+    for (size_t k = 0; k < m.sink.size(); k++) {
+      sink_mass += x[m.sink[k]];
+    }
+    restart = gamma * sink_mass + (1 - gamma) * total;
+    total = 0;
+    #pragma omp parallel for num_threads(nthreads) reduction(+:total) schedule(static, 1024)
+    for (int j = 0; j < n; j++) {
+      double s = 0;
+      for (int e = m.ptr[j]; e < m.ptr[j + 1]; e++) {
+        s += (theta * m.a[e] + (1 - theta) * m.b[e]) * x[m.source[e]];
+      }
+      y[j] = gamma * s + restart * prior[j];
+      total += y[j];
+    }
+    diff = 0;
+    #pragma omp parallel for num_threads(nthreads) reduction(+:diff) schedule(static)
+    for (int j = 0; j < n; j++) {
+      y[j] /= total;
+      diff += fabs(y[j] - x[j]);
+    }
+    if (diff < tol) {
+      x.swap(y);
+      break;
+    }
+    if (extrapolate > 0) {
+      if (iter >= 3 && iter % extrapolate == 0) {
+        quadraticExtrapolate(x0, x1, x, y, nthreads);
+      }
+      // keep the last two iterates
+      x0.swap(x1);
+      x1.swap(x);
+    }
+    x.swap(y);
+    if (iter % 100 == 0) {
+      Rcpp::checkUserInterrupt();
+    }
+  }
+  *change = diff;
+  return std::min(iter, max_iter);
+}
+
+//' Weighted PageRank centrality of a graph.
+//'
+//' The scores are computed by power iteration over the in-edges of each
+//' node, the dense transition matrix is not formed. The transition matrix is
+//' built once for all pairs of \code{gamma} and \code{theta}, each pair is
+//' started from the scores of the previous pair.
+//'
+//' @param graph An external pointer to the graph.
+//' @param gamma The damping factors.
+//' @param theta Tuning parameters leveraging node degree and strength, same
+//'   length as \code{gamma}.
+//' @param prior Prior information for restarting, sums to 1.
+//' @param tol Convergence tolerance of the L1 change of the scores.
+//' @param max_iter Maximum number of iterations.
+//' @param nthreads Number of threads.
+//' @param extrapolate If positive, quadratic extrapolation is applied every
+//'   \code{extrapolate} iterations.
+//' @return A list of the scores (one column for each pair of \code{gamma}
+//'   and \code{theta}), the number of iterations and whether the iteration
+//'   converged.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List wpr_cpp(SEXP graph,
+                   Rcpp::NumericVector gamma,
+                   Rcpp::NumericVector theta,
+                   std::vector<double> prior,
+                   double tol,
+                   int max_iter,
+                   int nthreads = 1,
+                   int extrapolate = 0) {
+  wdnet_graph &g = graphFromXPtr(graph);
+  int nnode = g.nnode;
+  if ((int) prior.size() != nnode) {
+    Rcpp::stop("The length of prior is not the number of nodes.");
+  }
+  wpr_matrix m;
+  buildWprMatrix(g.in, m);
+  int npar = gamma.size();
+  Rcpp::NumericMatrix score(nnode, npar);
+  Rcpp::IntegerVector niter(npar);
+  Rcpp::LogicalVector converged(npar);
+  std::vector<double> x(prior);
+  double change;
+  for (int k = 0; k < npar; k++) {
+    niter[k] = wprIterate(m, gamma[k], theta[k], prior, tol, max_iter,
+                          nthreads, extrapolate, x, &change);
+    converged[k] = change < tol;
+    std::copy(x.begin(), x.end(), score.begin() + (size_t) k * nnode);
+  }
+  return Rcpp::List::create(Rcpp::Named("wpr") = score,
+                            Rcpp::Named("niter") = niter,
+                            Rcpp::Named("converged") = converged);
+}
+
+// Radix heap (Ahuja et al., 1990) of nodes keyed by non-negative distances.
+// The bits of a non-negative double are ordered as the double itself, a node
+// is kept in the bucket of the highest bit where its key differs from the
+// last popped key. Dijkstra's algorithm pops keys in non-decreasing order,
+// so each node moves to lower buckets only. The position of each node is
+// tracked for decrease-key, hence the memory is O(n).
+struct radix_heap {
+  std::vector<int> bucket[65];
+  std::vector<int> where, pos;
+  std::vector<uint64_t> key;
+  uint64_t last;
+  int size;
+
+  radix_heap(int n) : where(n, -1), pos(n), key(n), last(0), size(0) {}
+
+  static inline uint64_t bits(double d) {
+    uint64_t k;
+    memcpy(&k, &d, sizeof(k));
+    return k;
+  }
+
+  inline int bucketOf(uint64_t k) const {
+    uint64_t x = k ^ last;
+    if (x == 0) {
+      return 0;
+    }
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(x);
+#else
+    int b = 0;
+    while (x) {
+      x >>= 1;
+      b++;
+    }
+    return b;
+#endif
+  }
+
+  inline void place(int v) {
+    int b = bucketOf(key[v]);
+    where[v] = b;
+    pos[v] = bucket[b].size();
+    bucket[b].push_back(v);
+  }
+
+  inline void remove(int v) {
+    std::vector<int> &bv = bucket[where[v]];
+    int u = bv.back();
+    bv[pos[v]] = u;
+    pos[u] = pos[v];
+    bv.pop_back();
+    where[v] = -1;
+  }
+
+  // Insert node v, or decrease its key if it is in the heap.
+  inline void push(int v, double d) {
+    if (where[v] >= 0) {
+      remove(v);
+    } else {
+      size++;
+    }
+    key[v] = bits(d);
+    place(v);
+  }
+
+  inline int pop() {
+    if (bucket[0].empty()) {
+      int b = 1;
+      while (bucket[b].empty()) {
+        b++;
+      }
+      std::vector<int> &bv = bucket[b];
+      uint64_t kmin = key[bv[0]];
+      for (size_t j = 1; j < bv.size(); j++) {
+        kmin = std::min(kmin, key[bv[j]]);
+      }
+      last = kmin;
+      for (size_t j = 0; j < bv.size(); j++) {
+        place(bv[j]);
+      }
+      bv.clear();
+    }
+    int v = bucket[0].back();
+    bucket[0].pop_back();
+    where[v] = -1;
+    size--;
+    return v;
+  }
+};
+
+// Workspace of one thread for single source shortest paths.
+struct dijkstra_workspace {
+  std::vector<double> dist;
+  std::vector<int> reached;
+  radix_heap heap;
+
+  dijkstra_workspace(int n) : dist(n, INFINITY), heap(n) {}
+
+  // Reset the distances of the nodes reached by the last search.
+  inline void clear() {
+    for (size_t j = 0; j < reached.size(); j++) {
+      dist[reached[j]] = INFINITY;
+    }
+    reached.clear();
+  }
+};
+
+// Dijkstra's algorithm from source s over edge lengths len. The reached
+// nodes are stored in w.reached, starting from s, with their distances in
+// w.dist; w.clear() must be called before the next search.
+static void dijkstraSearch(const csr_graph &g, const std::vector<double> &len,
+                           int s, dijkstra_workspace &w) {
+  double du, nd;
+  int u, v;
+  w.dist[s] = 0;
+  w.reached.push_back(s);
+  w.heap.last = 0;
+  w.heap.push(s, 0);
+  while (w.heap.size > 0) {
+    u = w.heap.pop();
+    du = w.dist[u];
+    for (int e = g.ptr[u]; e < g.ptr[u + 1]; e++) {
+      v = g.nbr[e];
+      nd = du + len[e];
+      if (nd < w.dist[v]) {
+        if (w.dist[v] == INFINITY) {
+          w.reached.push_back(v);
+        }
+        w.dist[v] = nd;
+        w.heap.push(v, nd);
+      }
+    }
+  }
+}
+
+// Edge lengths of the adjacency lists, i.e., the edge weights to the power
+// of -alpha, or alpha if the weights are distances.
+static void edgeLength(const csr_graph &g, double alpha, bool distance,
+                       std::vector<double> &len) {
+  len.resize(g.weight.size());
+  for (size_t e = 0; e < len.size(); e++) {
+    len[e] = distance ? pow(g.weight[e], alpha) : pow(1 / g.weight[e], alpha);
+  }
+}
+
+static int numThreads(int nthreads) {
+#ifdef _OPENMP
+  return std::max(1, std::min(nthreads, omp_get_max_threads()));
+#else
+  return 1;
+#endif
+}
+
+static int threadId() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+// Number of sources searched between checks of user interrupts.
+static const int SEARCH_BLOCK = 1024;
+
+//' Closeness centrality of a graph.
+//'
+//' One Dijkstra's search is run from each node over the adjacency lists, the
+//' closeness is accumulated during the search, so that the distance matrix
+//' is not formed. The sources are split among threads, each thread uses
+//' O(n) memory.
+//'
+//' @param graph An external pointer to the graph.
+//' @param alpha Tuning parameter, the length of an edge is its weight to the
+//'   power of \code{-alpha}, or \code{alpha} if \code{distance} is
+//'   \code{TRUE}.
+//' @param out Logical, whether to use the distances from (\code{TRUE}) or to
+//'   (\code{FALSE}) each node.
+//' @param harmonic Logical, whether to compute the harmonic or the standard
+//'   closeness.
+//' @param distance Logical, whether the edge weights are distances.
+//' @param nthreads Number of threads.
+//' @return Closeness centrality of the nodes.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::NumericVector closeness_cpp(SEXP graph,
+                                  double alpha,
+                                  bool out,
+                                  bool harmonic,
+                                  bool distance,
+                                  int nthreads = 1) {
+  wdnet_graph &net = graphFromXPtr(graph);
+  const csr_graph &g = out ? net.out : net.in;
+  int nnode = g.nnode;
+  std::vector<double> len;
+  edgeLength(g, alpha, distance, len);
+  nthreads = numThreads(nthreads);
+  std::vector<dijkstra_workspace> ws(nthreads, dijkstra_workspace(nnode));
+  Rcpp::NumericVector closeness(nnode);
+  double *c = closeness.begin();
+  for (int start = 0; start < nnode; start += SEARCH_BLOCK) {
+    int end = std::min(start + SEARCH_BLOCK, nnode);
+    #pragma omp parallel for num_threads(nthreads) schedule(dynamic, 8)
+    for (int s = start; s < end; s++) {
+      dijkstra_workspace &w = ws[threadId()];
+      dijkstraSearch(g, len, s, w);
+      double total = 0;
+      for (size_t j = 1; j < w.reached.size(); j++) {
+        total += harmonic ? 1 / w.dist[w.reached[j]] : w.dist[w.reached[j]];
+      }
+      if (harmonic) {
+        c[s] = total;
+      } else {
+        // unreachable nodes are at infinite distance
+        c[s] = (int) w.reached.size() == nnode ? 1 / total : 0;
+      }
+      w.clear();
+    }
+    Rcpp::checkUserInterrupt();
+  }
+  return closeness;
+}
+
+//' Harmonic closeness centrality from sampled pivots.
+//'
+//' One Dijkstra's search is run from each pivot in the reversed direction,
+//' which gives the distances from (or to) all the nodes to the pivot. For
+//' each node, the inverse distances to the pivots are summed within each
+//' stratum of pivots, together with their squares, for the estimate of the
+//' closeness and its variance. The strata are searched one after another,
+//' each thread sums into O(n) buffers that are added to the column of the
+//' stratum at its end.
+//'
+//' @param graph An external pointer to the graph.
+//' @param alpha Tuning parameter, the length of an edge is its weight to the
+//'   power of \code{-alpha}, or \code{alpha} if \code{distance} is
+//'   \code{TRUE}.
+//' @param out Logical, whether to use the distances from (\code{TRUE}) or to
+//'   (\code{FALSE}) each node.
+//' @param distance Logical, whether the edge weights are distances.
+//' @param pivot Pivot nodes (starts from 1).
+//' @param stratum Stratum of each pivot (starts from 1).
+//' @param nstrata Number of strata.
+//' @param nthreads Number of threads.
+//' @return A list of the sums and the sums of squares of the inverse
+//'   distances, one row for each node and one column for each stratum.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List closeness_pivot_cpp(SEXP graph,
+                               double alpha,
+                               bool out,
+                               bool distance,
+                               Rcpp::IntegerVector pivot,
+                               Rcpp::IntegerVector stratum,
+                               int nstrata,
+                               int nthreads = 1) {
+  wdnet_graph &net = graphFromXPtr(graph);
+  const csr_graph &g = out ? net.in : net.out;
+  int nnode = g.nnode;
+  std::vector<double> len;
+  edgeLength(g, alpha, distance, len);
+  int npivot = pivot.size();
+  for (int k = 0; k < npivot; k++) {
+    if (pivot[k] < 1 || pivot[k] > nnode ||
+        stratum[k] < 1 || stratum[k] > nstrata) {
+      Rcpp::stop("Pivot or stratum out of range.");
+    }
+  }
+  // pivots grouped by stratum, those of stratum h are
+  // order[first[h]], ..., order[first[h + 1] - 1]
+  std::vector<int> first(nstrata + 1, 0), order(npivot);
+  for (int k = 0; k < npivot; k++) {
+    first[stratum[k]]++;
+  }
+  for (int h = 0; h < nstrata; h++) {
+    first[h + 1] += first[h];
+  }
+  std::vector<int> next(first.begin(), first.end() - 1);
+  for (int k = 0; k < npivot; k++) {
+    order[next[stratum[k] - 1]++] = k;
+  }
+  nthreads = numThreads(nthreads);
+  std::vector<dijkstra_workspace> ws(nthreads, dijkstra_workspace(nnode));
+  // sums of each thread over the pivots of the current stratum
+  std::vector<std::vector<double> > sum(nthreads, std::vector<double>(nnode)),
+    sumsq(nthreads, std::vector<double>(nnode));
+  Rcpp::NumericMatrix total(nnode, nstrata), totalsq(nnode, nstrata);
+  for (int h = 0; h < nstrata; h++) {
+    if (first[h] == first[h + 1]) {
+      continue;
+    }
+    for (int start = first[h]; start < first[h + 1]; start += SEARCH_BLOCK) {
+      int end = std::min(start + SEARCH_BLOCK, first[h + 1]);
+      #pragma omp parallel for num_threads(nthreads) schedule(dynamic, 8)
+      for (int i = start; i < end; i++) {
+        int t = threadId();
+        dijkstra_workspace &w = ws[t];
+        dijkstraSearch(g, len, pivot[order[i]] - 1, w);
+        for (size_t j = 1; j < w.reached.size(); j++) {
+          double inv = 1 / w.dist[w.reached[j]];
+          sum[t][w.reached[j]] += inv;
+          sumsq[t][w.reached[j]] += inv * inv;
+        }
+        w.clear();
+      }
+      Rcpp::checkUserInterrupt();
+    }
+    // add the sums of the threads to the column of the stratum and reset
+    // them for the next stratum
+    double *c = total.begin() + (size_t) h * nnode;
+    double *csq = totalsq.begin() + (size_t) h * nnode;
+    #pragma omp parallel for num_threads(nthreads) schedule(static)
+    for (int v = 0; v < nnode; v++) {
+      for (int t = 0; t < nthreads; t++) {
+        c[v] += sum[t][v];
+        csq[v] += sumsq[t][v];
+        sum[t][v] = 0;
+        sumsq[t][v] = 0;
+      }
+    }
+  }
+  return Rcpp::List::create(Rcpp::Named("sum") = total,
+                            Rcpp::Named("sumsq") = totalsq);
+}
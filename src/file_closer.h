@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Close a file when it goes out of scope, including on errors and user
+// interrupts.
+struct file_closer {
+  FILE *fp;
+  explicit file_closer(FILE *fp = NULL) : fp(fp) {}
+  ~file_closer() {
+    if (fp != NULL) {
+      fclose(fp);
+    }
+  }
+};
+
+// Seek to a 64-bit offset, edgelist files may be larger than 2GB.
+inline int seekFile(FILE *fp, int64_t offset) {
+#ifdef _WIN32
+  return _fseeki64(fp, offset, SEEK_SET);
+#else
+  return fseeko(fp, (off_t) offset, SEEK_SET);
+#endif
+}
+
+// Close a file, returns false if a write to the file or closing it failed.
+inline bool closeFile(file_closer &f) {
+  bool ok = ferror(f.fp) == 0;
+  ok = (fclose(f.fp) == 0) && ok;
+  f.fp = NULL;
+  return ok;
+}
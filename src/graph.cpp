@@ -0,0 +1,200 @@
+#include <RcppArmadillo.h>
+#include "graph.h"
+// [[Rcpp::depends(RcppArmadillo)]]
+
+void buildCsr(const int *from, const int *to, const double *weight,
+              int nedge, int nnode, csr_graph &g) {
+  int m = 0;
+  for (int e = 0; e < nedge; e++) {
+    if (from[e] < 1 || from[e] > nnode || to[e] < 1 || to[e] > nnode) {
+      Rcpp::stop("Node index out of range.");
+    }
+    m += weight[e] > 0;
+  }
+  // counting sort of the edges by node in to, then a stable counting sort
+  // by node in from, so that the edges are sorted by (from, to) in O(m + n)
+  std::vector<int> pos(nnode + 1, 0), order(m), sorted(m);
+  for (int e = 0; e < nedge; e++) {
+    if (weight[e] > 0) {
+      pos[to[e]]++;
+    }
+  }
+  for (int i = 0; i < nnode; i++) {
+    pos[i + 1] += pos[i];
+  }
+  for (int e = 0; e < nedge; e++) {
+    if (weight[e] > 0) {
+      order[pos[to[e] - 1]++] = e;
+    }
+  }
+  g.nnode = nnode;
+  g.ptr.assign(nnode + 1, 0);
+  for (int k = 0; k < m; k++) {
+    g.ptr[from[order[k]]]++;
+  }
+  for (int i = 0; i < nnode; i++) {
+    g.ptr[i + 1] += g.ptr[i];
+  }
+  pos.assign(g.ptr.begin(), g.ptr.end());
+  for (int k = 0; k < m; k++) {
+    sorted[pos[from[order[k]] - 1]++] = order[k];
+  }
+  // merge parallel edges
+  g.nbr.resize(m);
+  g.weight.resize(m);
+  int k = 0, start, e;
+  for (int i = 0; i < nnode; i++) {
+    start = g.ptr[i];
+    g.ptr[i] = k;
+    for (int j = start; j < g.ptr[i + 1]; j++) {
+      e = sorted[j];
+      if (k > g.ptr[i] && g.nbr[k - 1] == to[e] - 1) {
+        g.weight[k - 1] += weight[e];
+      } else {
+        g.nbr[k] = to[e] - 1;
+        g.weight[k++] = weight[e];
+      }
+    }
+  }
+  g.ptr[nnode] = k;
+  g.nbr.resize(k);
+  g.weight.resize(k);
+}
+
+wdnet_graph &graphFromXPtr(SEXP graph) {
+  if (TYPEOF(graph) != EXTPTRSXP) {
+    Rcpp::stop("Not a graph built by wdnet_graph().");
+  }
+  Rcpp::XPtr<wdnet_graph> ptr(graph);
+  if (ptr.get() == NULL) {
+    Rcpp::stop("The graph is no longer available, e.g., it was saved and "
+               "loaded again; rebuild it with wdnet_graph().");
+  }
+  return *ptr;
+}
+
+//' Build a graph from an edgelist.
+//'
+//' The out-edges and in-edges of each node are sorted with counting sorts
+//' and the parallel edges are merged, so that the graph is built in time
+//' linear in the number of edges and nodes.
+//'
+//' @param snode Source nodes.
+//' @param tnode Target nodes.
+//' @param weight Edgeweight.
+//' @param nnode Number of nodes.
+//' @param directed Logical, whether the network is directed.
+//' @return An external pointer to the graph.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+SEXP graph_build_cpp(Rcpp::IntegerVector snode,
+                     Rcpp::IntegerVector tnode,
+                     Rcpp::NumericVector weight,
+                     int nnode,
+                     bool directed) {
+  int nedge = snode.size();
+  Rcpp::XPtr<wdnet_graph> ptr(new wdnet_graph, true);
+  wdnet_graph &g = *ptr;
+  g.nnode = nnode;
+  g.directed = directed;
+  g.snode.assign(snode.begin(), snode.end());
+  g.tnode.assign(tnode.begin(), tnode.end());
+  g.weight.assign(weight.begin(), weight.end());
+  buildCsr(g.snode.data(), g.tnode.data(), g.weight.data(), nedge, nnode,
+           g.out);
+  buildCsr(g.tnode.data(), g.snode.data(), g.weight.data(), nedge, nnode,
+           g.in);
+  g.outs.assign(nnode, 0.0);
+  g.ins.assign(nnode, 0.0);
+  for (int e = 0; e < nedge; e++) {
+    g.outs[g.snode[e] - 1] += g.weight[e];
+    g.ins[g.tnode[e] - 1] += g.weight[e];
+  }
+  g.outd.resize(nnode);
+  g.ind.resize(nnode);
+  for (int i = 0; i < nnode; i++) {
+    g.outd[i] = g.out.ptr[i + 1] - g.out.ptr[i];
+    g.ind[i] = g.in.ptr[i + 1] - g.in.ptr[i];
+  }
+  return ptr;
+}
+
+//' Cached strengths and degrees of a graph.
+//'
+//' @param graph An external pointer to the graph.
+//' @return Out- and in-strength, out- and in-degree (distinct neighbors).
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List graph_strength_cpp(SEXP graph) {
+  wdnet_graph &g = graphFromXPtr(graph);
+  Rcpp::List ret;
+  ret["outstrength"] = g.outs;
+  ret["instrength"] = g.ins;
+  ret["outdegree"] = g.outd;
+  ret["indegree"] = g.ind;
+  return ret;
+}
+
+//' Edges of a graph, as given when it was built.
+//'
+//' @param graph An external pointer to the graph.
+//' @return A list of edgelist, edgeweight, number of nodes and whether the
+//'   network is directed.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List graph_edges_cpp(SEXP graph) {
+  wdnet_graph &g = graphFromXPtr(graph);
+  int nedge = g.snode.size();
+  Rcpp::IntegerMatrix edgelist(nedge, 2);
+  std::copy(g.snode.begin(), g.snode.end(), edgelist.begin());
+  std::copy(g.tnode.begin(), g.tnode.end(), edgelist.begin() + nedge);
+  Rcpp::List ret;
+  ret["edgelist"] = edgelist;
+  ret["edgeweight"] = g.weight;
+  ret["nnode"] = g.nnode;
+  ret["directed"] = g.directed;
+  return ret;
+}
+
+//' Compressed columns of the weighted adjacency matrix of a graph.
+//'
+//' The in-edges of each node are the columns of the adjacency matrix, with
+//' row indices sorted and parallel edges merged, as in a \code{dgCMatrix}.
+//'
+//' @param graph An external pointer to the graph.
+//' @param loops Logical, whether to keep self-loops.
+//' @return A list of row indices (starts from 0), column pointers and
+//'   values.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List graph_csc_cpp(SEXP graph, bool loops = true) {
+  wdnet_graph &g = graphFromXPtr(graph);
+  const csr_graph &c = g.in;
+  Rcpp::IntegerVector p(g.nnode + 1);
+  std::vector<int> i;
+  std::vector<double> x;
+  i.reserve(c.nbr.size());
+  x.reserve(c.nbr.size());
+  for (int j = 0; j < g.nnode; j++) {
+    for (int k = c.ptr[j]; k < c.ptr[j + 1]; k++) {
+      if (loops || c.nbr[k] != j) {
+        i.push_back(c.nbr[k]);
+        x.push_back(c.weight[k]);
+      }
+    }
+    p[j + 1] = i.size();
+  }
+  Rcpp::List ret;
+  ret["i"] = i;
+  ret["p"] = p;
+  ret["x"] = x;
+  return ret;
+}
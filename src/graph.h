@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <Rcpp.h>
+
+// Adjacency lists in compressed form, the neighbors of node i are nbr[k]
+// for k from ptr[i] to ptr[i + 1] - 1, sorted, with the edge weights in
+// weight[k]. Parallel edges are merged.
+struct csr_graph {
+  int nnode;
+  std::vector<int> ptr, nbr;
+  std::vector<double> weight;
+};
+
+// Build the adjacency lists of the nodes in from (node ids start from 1),
+// i.e., the out-edges if from is the source nodes and the in-edges if from
+// is the target nodes. Edges with non-positive weights are dropped.
+void buildCsr(const int *from, const int *to, const double *weight,
+              int nedge, int nnode, csr_graph &g);
+
+// A network built once and shared by the analyses. The edges are kept as
+// given, for the analyses that count each edge, together with the
+// out-edges (CSR) and in-edges (CSC) of each node. The strengths are
+// aggregated over all the edges, the degrees count the distinct neighbors
+// over the edges with positive weights. An undirected network is stored as
+// given, the analyses treat its edges in both directions.
+struct wdnet_graph {
+  int nnode;
+  bool directed;
+  std::vector<int> snode, tnode;
+  std::vector<double> weight;
+  csr_graph out, in;
+  std::vector<double> outs, ins, outd, ind;
+};
+
+// The graph behind an external pointer created by graph_build_cpp.
+wdnet_graph &graphFromXPtr(SEXP graph);
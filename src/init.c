@@ -7,50 +7,78 @@
    Check these declarations against the C/Fortran source code.
 */
 
-/* .C calls */
-extern void netSim(void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *, void *);
-
 /* .Call calls */
-extern SEXP _wdnet_dprewire_directed_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_dprewire_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_assortcoef_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_assortcoef_file_cpp(SEXP, SEXP);
+extern SEXP _wdnet_assortcoef_graph_cpp(SEXP, SEXP);
+extern SEXP _wdnet_closeness_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_closeness_pivot_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_dprewire_directed_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_dprewire_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_feature_assort_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP _wdnet_fill_weight_cpp(SEXP, SEXP, SEXP);
 extern SEXP _wdnet_find_node_cpp(SEXP, SEXP);
 extern SEXP _wdnet_find_node_undirected_cpp(SEXP, SEXP, SEXP, SEXP);
 extern SEXP _wdnet_fx(SEXP, SEXP, SEXP);
+extern SEXP _wdnet_graph_build_cpp(SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_graph_csc_cpp(SEXP, SEXP);
+extern SEXP _wdnet_graph_edges_cpp(SEXP);
+extern SEXP _wdnet_graph_strength_cpp(SEXP);
 extern SEXP _wdnet_hello_world();
+extern SEXP _wdnet_joint_dist_cpp(SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_joint_dist_graph_cpp(SEXP, SEXP);
+extern SEXP _wdnet_match_pair_cpp(SEXP, SEXP, SEXP, SEXP);
 extern SEXP _wdnet_node_strength_cpp(SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_rpanet_bag_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_rpanet_binary_directed(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_rpanet_binary_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_rpanet_linear_directed_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP _wdnet_rpanet_linear_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_rpanet_bag_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_rpanet_binary_directed(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_rpanet_binary_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_rpanet_checkpoint_info_cpp(SEXP);
+extern SEXP _wdnet_rpanet_linear_directed_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_rpanet_linear_undirected_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 extern SEXP _wdnet_sample_node_cpp(SEXP);
-
-static const R_CMethodDef CEntries[] = {
-    {"netSim", (DL_FUNC) &netSim, 12},
-    {NULL, NULL, 0}
-};
+extern SEXP _wdnet_solve_eta_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_solve_eta_grid_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP _wdnet_wpr_cpp(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP netSim(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_wdnet_dprewire_directed_cpp",        (DL_FUNC) &_wdnet_dprewire_directed_cpp,        11},
-    {"_wdnet_dprewire_undirected_cpp",      (DL_FUNC) &_wdnet_dprewire_undirected_cpp,      10},
+    {"_wdnet_assortcoef_cpp",               (DL_FUNC) &_wdnet_assortcoef_cpp,                6},
+    {"_wdnet_assortcoef_file_cpp",          (DL_FUNC) &_wdnet_assortcoef_file_cpp,           2},
+    {"_wdnet_assortcoef_graph_cpp",         (DL_FUNC) &_wdnet_assortcoef_graph_cpp,          2},
+    {"_wdnet_closeness_cpp",                (DL_FUNC) &_wdnet_closeness_cpp,                 6},
+    {"_wdnet_closeness_pivot_cpp",          (DL_FUNC) &_wdnet_closeness_pivot_cpp,           8},
+    {"_wdnet_dprewire_directed_cpp",        (DL_FUNC) &_wdnet_dprewire_directed_cpp,        15},
+    {"_wdnet_dprewire_undirected_cpp",      (DL_FUNC) &_wdnet_dprewire_undirected_cpp,      14},
+    {"_wdnet_feature_assort_cpp",           (DL_FUNC) &_wdnet_feature_assort_cpp,            7},
     {"_wdnet_fill_weight_cpp",              (DL_FUNC) &_wdnet_fill_weight_cpp,               3},
     {"_wdnet_find_node_cpp",                (DL_FUNC) &_wdnet_find_node_cpp,                 2},
     {"_wdnet_find_node_undirected_cpp",     (DL_FUNC) &_wdnet_find_node_undirected_cpp,      4},
     {"_wdnet_fx",                           (DL_FUNC) &_wdnet_fx,                            3},
+    {"_wdnet_graph_build_cpp",              (DL_FUNC) &_wdnet_graph_build_cpp,               5},
+    {"_wdnet_graph_csc_cpp",                (DL_FUNC) &_wdnet_graph_csc_cpp,                 2},
+    {"_wdnet_graph_edges_cpp",              (DL_FUNC) &_wdnet_graph_edges_cpp,               1},
+    {"_wdnet_graph_strength_cpp",           (DL_FUNC) &_wdnet_graph_strength_cpp,            1},
     {"_wdnet_hello_world",                  (DL_FUNC) &_wdnet_hello_world,                   0},
+    {"_wdnet_joint_dist_cpp",               (DL_FUNC) &_wdnet_joint_dist_cpp,                4},
+    {"_wdnet_joint_dist_graph_cpp",         (DL_FUNC) &_wdnet_joint_dist_graph_cpp,          2},
+    {"_wdnet_match_pair_cpp",               (DL_FUNC) &_wdnet_match_pair_cpp,                4},
     {"_wdnet_node_strength_cpp",            (DL_FUNC) &_wdnet_node_strength_cpp,             5},
-    {"_wdnet_rpanet_bag_cpp",               (DL_FUNC) &_wdnet_rpanet_bag_cpp,                8},
-    {"_wdnet_rpanet_binary_directed",       (DL_FUNC) &_wdnet_rpanet_binary_directed,       15},
-    {"_wdnet_rpanet_binary_undirected_cpp", (DL_FUNC) &_wdnet_rpanet_binary_undirected_cpp, 11},
-    {"_wdnet_rpanet_linear_directed_cpp",   (DL_FUNC) &_wdnet_rpanet_linear_directed_cpp,   15},
-    {"_wdnet_rpanet_linear_undirected_cpp", (DL_FUNC) &_wdnet_rpanet_linear_undirected_cpp, 11},
+    {"_wdnet_rpanet_bag_cpp",               (DL_FUNC) &_wdnet_rpanet_bag_cpp,                9},
+    {"_wdnet_rpanet_binary_directed",       (DL_FUNC) &_wdnet_rpanet_binary_directed,       17},
+    {"_wdnet_rpanet_binary_undirected_cpp", (DL_FUNC) &_wdnet_rpanet_binary_undirected_cpp, 13},
+    {"_wdnet_rpanet_checkpoint_info_cpp",   (DL_FUNC) &_wdnet_rpanet_checkpoint_info_cpp,    1},
+    {"_wdnet_rpanet_linear_directed_cpp",   (DL_FUNC) &_wdnet_rpanet_linear_directed_cpp,   17},
+    {"_wdnet_rpanet_linear_undirected_cpp", (DL_FUNC) &_wdnet_rpanet_linear_undirected_cpp, 13},
     {"_wdnet_sample_node_cpp",              (DL_FUNC) &_wdnet_sample_node_cpp,               1},
+    {"_wdnet_solve_eta_cpp",                (DL_FUNC) &_wdnet_solve_eta_cpp,                 8},
+    {"_wdnet_solve_eta_grid_cpp",           (DL_FUNC) &_wdnet_solve_eta_grid_cpp,            9},
+    {"_wdnet_wpr_cpp",                      (DL_FUNC) &_wdnet_wpr_cpp,                       8},
+    {"netSim",                              (DL_FUNC) &netSim,                               7},
     {NULL, NULL, 0}
 };
 
 void R_init_wdnet(DllInfo *dll)
 {
-    R_registerRoutines(dll, CEntries, CallEntries, NULL, NULL);
+    R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
 }
@@ -0,0 +1,614 @@
+#include <RcppArmadillo.h>
+#include <stdint.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "graph.h"
+// [[Rcpp::depends(RcppArmadillo)]]
+
+// Sorted distinct values of non-negative integers x, rank[k] is the index of
+// x[k] among them. Values are grouped with a counting sort.
+static std::vector<int> rankValues(const std::vector<int> &x,
+                                   std::vector<int> &rank) {
+  int maxv = 0;
+  for (size_t k = 0; k < x.size(); k++) {
+    maxv = std::max(maxv, x[k]);
+  }
+  std::vector<int> code(maxv + 1, -1), value;
+  for (size_t k = 0; k < x.size(); k++) {
+    code[x[k]] = 0;
+  }
+  for (int v = 0; v <= maxv; v++) {
+    if (code[v] == 0) {
+      code[v] = value.size();
+      value.push_back(v);
+    }
+  }
+  rank.resize(x.size());
+  for (size_t k = 0; k < x.size(); k++) {
+    rank[k] = code[x[k]];
+  }
+  return value;
+}
+
+// Cross tabulation of codes x and y, indices of labels xlab and ylab, divided
+// by the number of elements. As table() in R, only observed codes are kept and
+// labelled. xcode and ycode map a code to its row and column, -1 if not
+// observed.
+static Rcpp::NumericMatrix crossTable(const std::vector<int> &x,
+                                      const std::vector<int> &y,
+                                      Rcpp::CharacterVector xlab,
+                                      Rcpp::CharacterVector ylab,
+                                      std::vector<int> &xcode,
+                                      std::vector<int> &ycode) {
+  int n = x.size(), nrow = 0, ncol = 0;
+  xcode.assign(xlab.size(), -1);
+  ycode.assign(ylab.size(), -1);
+  for (int k = 0; k < n; k++) {
+    xcode[x[k]] = 0;
+    ycode[y[k]] = 0;
+  }
+  for (int i = 0; i < xlab.size(); i++) {
+    if (xcode[i] == 0) {
+      xcode[i] = nrow++;
+    }
+  }
+  for (int j = 0; j < ylab.size(); j++) {
+    if (ycode[j] == 0) {
+      ycode[j] = ncol++;
+    }
+  }
+  Rcpp::CharacterVector rowlab(nrow), collab(ncol);
+  for (int i = 0; i < xlab.size(); i++) {
+    if (xcode[i] >= 0) {
+      rowlab[xcode[i]] = xlab[i];
+    }
+  }
+  for (int j = 0; j < ylab.size(); j++) {
+    if (ycode[j] >= 0) {
+      collab[ycode[j]] = ylab[j];
+    }
+  }
+  Rcpp::NumericMatrix ret(nrow, ncol);
+  for (int k = 0; k < n; k++) {
+    ret(xcode[x[k]], ycode[y[k]]) += 1;
+  }
+  for (int k = 0; k < ret.size(); k++) {
+    ret[k] /= n;
+  }
+  ret.attr("dimnames") = Rcpp::List::create(Rcpp::Named("source") = rowlab,
+                                            Rcpp::Named("target") = collab);
+  return ret;
+}
+
+// Key of an integer pair.
+static inline uint64_t pairKey(int a, int b) {
+  return ((uint64_t) (uint32_t) a << 32) | (uint32_t) b;
+}
+
+// Node-level and edge-level degree distributions of the directed edges
+// (snode[k], tnode[k]), node ids start from 1; see joint_dist_cpp.
+static Rcpp::List jointDist(const int *snode, const int *tnode, int nedge,
+                            int nnode, bool joint_dist) {
+  std::vector<int> outd(nnode, 0), ind(nnode, 0);
+  for (int k = 0; k < nedge; k++) {
+    outd[snode[k] - 1]++;
+    ind[tnode[k] - 1]++;
+  }
+  std::vector<int> rank_out, rank_in;
+  std::vector<int> d_out = rankValues(outd, rank_out);
+  std::vector<int> d_in = rankValues(ind, rank_in);
+  int m = d_out.size(), n = d_in.size();
+  Rcpp::CharacterVector lab_out(m), lab_in(n);
+  for (int i = 0; i < m; i++) {
+    lab_out[i] = std::to_string(d_out[i]);
+  }
+  for (int j = 0; j < n; j++) {
+    lab_in[j] = std::to_string(d_in[j]);
+  }
+  Rcpp::NumericMatrix nu(m, n);
+  for (int i = 0; i < nnode; i++) {
+    nu(rank_out[i], rank_in[i]) += 1;
+  }
+  for (int k = 0; k < nu.size(); k++) {
+    nu[k] /= nnode;
+  }
+  nu.attr("dimnames") = Rcpp::List::create(Rcpp::Named("outdegree") = lab_out,
+                                           Rcpp::Named("indegree") = lab_in);
+  Rcpp::List ret;
+  ret["nu"] = nu;
+  ret["d_out"] = Rcpp::NumericVector(d_out.begin(), d_out.end());
+  ret["d_in"] = Rcpp::NumericVector(d_in.begin(), d_in.end());
+  if (! joint_dist) {
+    return ret;
+  }
+
+  std::vector<int> so(nedge), si(nedge), to(nedge), ti(nedge);
+  for (int k = 0; k < nedge; k++) {
+    so[k] = rank_out[snode[k] - 1];
+    si[k] = rank_in[snode[k] - 1];
+    to[k] = rank_out[tnode[k] - 1];
+    ti[k] = rank_in[tnode[k] - 1];
+  }
+  std::vector<int> xcode, ycode;
+  Rcpp::List e;
+  e["outout"] = crossTable(so, to, lab_out, lab_out, xcode, ycode);
+  e["outin"] = crossTable(so, ti, lab_out, lab_in, xcode, ycode);
+  e["inout"] = crossTable(si, to, lab_in, lab_out, xcode, ycode);
+  e["inin"] = crossTable(si, ti, lab_in, lab_in, xcode, ycode);
+
+  // node types are the distinct (out-degree, in-degree) pairs, sorted by
+  // out-degree then in-degree
+  std::vector<uint64_t> key(nnode);
+  for (int i = 0; i < nnode; i++) {
+    key[i] = pairKey(rank_out[i], rank_in[i]);
+  }
+  std::vector<uint64_t> type_key(key);
+  std::sort(type_key.begin(), type_key.end());
+  type_key.erase(std::unique(type_key.begin(), type_key.end()),
+                 type_key.end());
+  Rcpp::CharacterVector lab_type(type_key.size());
+  for (size_t l = 0; l < type_key.size(); l++) {
+    lab_type[l] = std::to_string(d_out[type_key[l] >> 32]) + "-" +
+      std::to_string(d_in[type_key[l] & 0xFFFFFFFF]);
+  }
+  std::vector<int> node_type(nnode), ts(nedge), tt(nedge);
+  for (int i = 0; i < nnode; i++) {
+    node_type[i] = std::lower_bound(type_key.begin(), type_key.end(),
+                                    key[i]) - type_key.begin();
+  }
+  for (int k = 0; k < nedge; k++) {
+    ts[k] = node_type[snode[k] - 1];
+    tt[k] = node_type[tnode[k] - 1];
+  }
+  ret["e"] = e;
+  ret["eta"] = crossTable(ts, tt, lab_type, lab_type, xcode, ycode);
+  Rcpp::IntegerVector index_s(nedge), index_t(nedge);
+  for (int k = 0; k < nedge; k++) {
+    index_s[k] = xcode[ts[k]];
+    index_t[k] = ycode[tt[k]];
+  }
+  ret["index_s"] = index_s;
+  ret["index_t"] = index_t;
+  return ret;
+}
+
+//' Node-level and edge-level degree distributions of a directed network.
+//' Defined for \code{wdnet::get_dist}.
+//'
+//' @param snode Source nodes, starts from 1.
+//' @param tnode Target nodes, starts from 1.
+//' @param nnode Number of nodes.
+//' @param joint_dist Logical, whether to return edge-level distributions.
+//' @return Distinct out- and in-degrees, the joint distribution of out- and
+//'   in-degree of nodes (nu). If joint_dist is true, also the four joint
+//'   distributions of degrees of source and target nodes (e), the joint
+//'   distribution of out-in-degree types of source and target nodes (eta) with
+//'   types ordered by out-degree then in-degree, and the row and column index
+//'   (starts from 0) of each edge in eta.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List joint_dist_cpp(Rcpp::IntegerVector snode,
+                          Rcpp::IntegerVector tnode,
+                          int nnode,
+                          bool joint_dist) {
+  return jointDist(snode.begin(), tnode.begin(), snode.size(), nnode,
+                   joint_dist);
+}
+
+//' Node-level and edge-level degree distributions of a graph. Defined for
+//' \code{wdnet::get_dist}. The edges of an undirected graph are counted in
+//' both directions.
+//'
+//' @param graph An external pointer to the graph.
+//' @param joint_dist Logical, whether to return edge-level distributions.
+//' @return See \code{joint_dist_cpp}.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List joint_dist_graph_cpp(SEXP graph, bool joint_dist) {
+  wdnet_graph &net = graphFromXPtr(graph);
+  int nedge = net.snode.size();
+  if (net.directed) {
+    return jointDist(net.snode.data(), net.tnode.data(), nedge, net.nnode,
+                     joint_dist);
+  }
+  std::vector<int> snode(net.snode), tnode(net.tnode);
+  snode.insert(snode.end(), net.tnode.begin(), net.tnode.end());
+  tnode.insert(tnode.end(), net.snode.begin(), net.snode.end());
+  return jointDist(snode.data(), tnode.data(), 2 * nedge, net.nnode,
+                   joint_dist);
+}
+
+//' Match integer pairs (x1, x2) to (table1, table2) with a hash table.
+//' Defined for \code{wdnet::dprewire}, where edges are matched to the rows or
+//' columns of eta by the degrees of their source or target nodes.
+//'
+//' @param x1 First element of the pairs to be matched.
+//' @param x2 Second element of the pairs to be matched. If empty, only x1 is
+//'   matched.
+//' @param table1 First element of the pairs to be matched against.
+//' @param table2 Second element of the pairs to be matched against. Empty if
+//'   x2 is empty.
+//' @return Index (starts from 0) of the first match of each pair, NA if there
+//'   is no match.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::IntegerVector match_pair_cpp(Rcpp::IntegerVector x1,
+                                   Rcpp::IntegerVector x2,
+                                   Rcpp::IntegerVector table1,
+                                   Rcpp::IntegerVector table2) {
+  bool single = x2.size() == 0;
+  int n = x1.size(), ntable = table1.size();
+  std::unordered_map<uint64_t, int> index;
+  index.reserve(ntable);
+  for (int l = ntable - 1; l >= 0; l--) {
+    index[pairKey(table1[l], single ? 0 : table2[l])] = l;
+  }
+  Rcpp::IntegerVector ret(n);
+  for (int k = 0; k < n; k++) {
+    std::unordered_map<uint64_t, int>::const_iterator it =
+      index.find(pairKey(x1[k], single ? 0 : x2[k]));
+    ret[k] = it == index.end() ? NA_INTEGER : it->second;
+  }
+  return ret;
+}
+
+// Mean of g weighted by eta * exp(delta * g) over the support of eta, where
+// g is x[i] * y[j]. The weighted variance is returned in var.
+static double tiltedMean(const arma::mat &eta, const double *x,
+                         const double *y, double delta, double *var) {
+  int m = eta.n_rows, n = eta.n_cols;
+  double gmax = -INFINITY, s0 = 0, s1 = 0, s2 = 0;
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < m; i++) {
+      if (eta(i, j) > 0) {
+        gmax = std::max(gmax, delta * x[i] * y[j]);
+      }
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < m; i++) {
+      if (eta(i, j) > 0) {
+        double g = x[i] * y[j];
+        double w = eta(i, j) * exp(delta * g - gmax);
+        s0 += w;
+        s1 += w * g;
+        s2 += w * g * g;
+      }
+    }
+  }
+  s1 /= s0;
+  *var = s2 / s0 - s1 * s1;
+  return s1;
+}
+
+// Shift delta such that the tilted mean of g equals target, found by Newton
+// steps safeguarded with bisection. Returns -INFINITY if target is below the
+// attainable range of the tilted mean, and INFINITY if it is above.
+static double solveShift(const arma::mat &eta, const double *x,
+                         const double *y, double target, double tol) {
+  double var, lo = -1, hi = 1;
+  double f = tiltedMean(eta, x, y, 0, &var) - target;
+  if (fabs(f) <= tol) {
+    return 0;
+  }
+  // bracket the root, the tilted mean is increasing in delta
+  int k = 0;
+  while (tiltedMean(eta, x, y, lo, &var) > target) {
+    hi = lo;
+    lo *= 2;
+    if (++k > 60) {
+      return -INFINITY;
+    }
+  }
+  while (tiltedMean(eta, x, y, hi, &var) < target) {
+    lo = hi;
+    hi *= 2;
+    if (++k > 60) {
+      return INFINITY;
+    }
+  }
+  double delta = 0.5 * (lo + hi);
+  for (k = 0; k < 200; k++) {
+    f = tiltedMean(eta, x, y, delta, &var) - target;
+    if (fabs(f) <= tol) {
+      break;
+    }
+    if (f > 0) {
+      hi = delta;
+    } else {
+      lo = delta;
+    }
+    delta -= f / var;
+    if (! (delta > lo && delta < hi)) {
+      delta = 0.5 * (lo + hi);
+    }
+  }
+  return delta;
+}
+
+// Solve for eta, see solve_eta_cpp(). The iteration starts from the
+// multipliers in lambda; lambda, eta and rho are updated in place. R API is
+// only called if interrupt is true, so that solves can run in parallel.
+// Returns the status.
+static std::string solveEta(const arma::vec &s, const arma::vec &t,
+                            const arma::mat &x, const arma::mat &y,
+                            const std::vector<double> &lower,
+                            const std::vector<double> &upper,
+                            double tol, int max_iter, bool interrupt,
+                            arma::vec &lambda, arma::mat &eta,
+                            arma::vec &rho, int *niter) {
+  int m = s.size(), n = t.size(), nk = x.n_cols, iter;
+  std::vector<double> rowsum(m);
+  std::string status = "solver_error";
+  // the exponents are shifted by their maximum over the support, as in
+  // tiltedMean(), so that warm starts with large multipliers do not overflow
+  double total = 0, gmax = -INFINITY;
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < m; i++) {
+      double g = 0;
+      for (int k = 0; k < nk; k++) {
+        g += lambda[k] * x(i, k) * y(j, k);
+      }
+      eta(i, j) = g;
+      if (s[i] * t[j] > 0) {
+        gmax = std::max(gmax, g);
+      }
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < m; i++) {
+      eta(i, j) = s[i] * t[j] > 0 ? s[i] * t[j] * exp(eta(i, j) - gmax) : 0;
+      total += eta(i, j);
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < m; i++) {
+      eta(i, j) /= total;
+    }
+  }
+  for (iter = 1; iter <= max_iter; iter++) {
+    // lambda, the multiplier of rho_k, is positive only if rho_k is at its
+    // lower bound and negative only if rho_k is at its upper bound
+    bool infeasible = false;
+    for (int k = 0; k < nk; k++) {
+      if (lower[k] == -INFINITY && upper[k] == INFINITY) {
+        continue;
+      }
+      const double *xk = x.colptr(k), *yk = y.colptr(k);
+      double dlo = -INFINITY, dhi = INFINITY, delta;
+      if (lower[k] > -INFINITY) {
+        dlo = solveShift(eta, xk, yk, lower[k], tol / 10);
+      }
+      if (upper[k] < INFINITY) {
+        dhi = solveShift(eta, xk, yk, upper[k], tol / 10);
+      }
+      // a lower bound below the attainable range (dlo = -INFINITY) or an
+      // upper bound above it (dhi = INFINITY) is slack; only a lower bound
+      // above or an upper bound below the attainable range is infeasible
+      if (dlo == INFINITY || dhi == -INFINITY) {
+        infeasible = true;
+        break;
+      }
+      delta = std::min(std::max(-lambda[k], dlo), dhi);
+      lambda[k] += delta;
+      total = 0;
+      gmax = -INFINITY;
+      for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+          if (eta(i, j) > 0) {
+            gmax = std::max(gmax, delta * xk[i] * yk[j]);
+          }
+        }
+      }
+      for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+          if (eta(i, j) > 0) {
+            eta(i, j) *= exp(delta * xk[i] * yk[j] - gmax);
+            total += eta(i, j);
+          }
+        }
+      }
+      for (int j = 0; j < n; j++) {
+        for (int i = 0; i < m; i++) {
+          eta(i, j) /= total;
+        }
+      }
+    }
+    if (infeasible) {
+      status = "infeasible";
+      break;
+    }
+    // iterative proportional fitting
+    std::fill(rowsum.begin(), rowsum.end(), 0.0);
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < m; i++) {
+        rowsum[i] += eta(i, j);
+      }
+    }
+    for (int j = 0; j < n; j++) {
+      double colsum = 0;
+      for (int i = 0; i < m; i++) {
+        eta(i, j) *= s[i] / rowsum[i];
+        colsum += eta(i, j);
+      }
+      for (int i = 0; i < m; i++) {
+        eta(i, j) *= t[j] / colsum;
+      }
+    }
+    // columns are exact after scaling, check rows and rho
+    double err = 0;
+    std::fill(rowsum.begin(), rowsum.end(), 0.0);
+    for (int k = 0; k < nk; k++) {
+      rho[k] = 0;
+    }
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < m; i++) {
+        rowsum[i] += eta(i, j);
+        for (int k = 0; k < nk; k++) {
+          rho[k] += eta(i, j) * x(i, k) * y(j, k);
+        }
+      }
+    }
+    for (int i = 0; i < m; i++) {
+      err = std::max(err, fabs(rowsum[i] - s[i]));
+    }
+    for (int k = 0; k < nk; k++) {
+      err = std::max(err, lower[k] - rho[k]);
+      err = std::max(err, rho[k] - upper[k]);
+    }
+    if (err <= tol) {
+      status = "optimal";
+      break;
+    }
+    if (interrupt && (iter & 0xFF) == 0) {
+      Rcpp::checkUserInterrupt();
+    }
+  }
+  *niter = std::min(iter, max_iter);
+  return status;
+}
+
+// Kullback-Leibler divergence of eta from the product of its marginals.
+static double divergence(const arma::mat &eta, const arma::vec &s,
+                         const arma::vec &t) {
+  double kl = 0;
+  for (arma::uword j = 0; j < eta.n_cols; j++) {
+    for (arma::uword i = 0; i < eta.n_rows; i++) {
+      if (eta(i, j) > 0) {
+        kl += eta(i, j) * log(eta(i, j) / s[i] / t[j]);
+      }
+    }
+  }
+  return kl;
+}
+
+//' Solve for eta with linear constraints on assortativity coefficients.
+//' Defined for \code{wdnet::get_eta_directed} and
+//' \code{wdnet::get_eta_undirected}.
+//'
+//' Finds the eta closest to the product of its marginals in Kullback-Leibler
+//' divergence, subject to the marginals and lower <= rho_k <= upper, where
+//' rho_k = sum_ij eta_ij x_k[i] y_k[j] with standardized degrees x_k and y_k.
+//' The solution is eta_ij = a_i b_j exp(sum_k lambda_k x_k[i] y_k[j]). Row
+//' and column scaling (iterative proportional fitting) alternates with
+//' coordinate updates of lambda.
+//'
+//' @param s Row marginals.
+//' @param t Column marginals.
+//' @param x Matrix, column k is x_k.
+//' @param y Matrix, column k is y_k.
+//' @param lower Lower bounds of rho, -Inf if not bounded.
+//' @param upper Upper bounds of rho, Inf if not bounded.
+//' @param tol Tolerance on the marginals and rho.
+//' @param max_iter Maximum number of iterations.
+//' @return eta, rho, lambda, number of iterations, status and the
+//'   Kullback-Leibler divergence.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List solve_eta_cpp(arma::vec s,
+                         arma::vec t,
+                         arma::mat x,
+                         arma::mat y,
+                         std::vector<double> lower,
+                         std::vector<double> upper,
+                         double tol,
+                         int max_iter) {
+  int nk = x.n_cols, niter;
+  arma::mat eta(s.size(), t.size());
+  arma::vec lambda(nk, arma::fill::zeros), rho(nk, arma::fill::zeros);
+  std::string status = solveEta(s, t, x, y, lower, upper, tol, max_iter,
+                                true, lambda, eta, rho, &niter);
+  Rcpp::List ret;
+  ret["eta"] = eta;
+  ret["rho"] = rho;
+  ret["lambda"] = lambda;
+  ret["num_iters"] = niter;
+  ret["status"] = status;
+  ret["value"] = divergence(eta, s, t);
+  return ret;
+}
+
+//' Solve for eta over a grid of constraints on assortativity coefficients.
+//' Defined for \code{wdnet::dprewire.grid}.
+//'
+//' The grid is split into nthreads contiguous blocks solved in parallel.
+//' Within a block, each solve is warm started from the multipliers of the
+//' previous grid point.
+//'
+//' @param s Row marginals.
+//' @param t Column marginals.
+//' @param x Matrix, column k is x_k.
+//' @param y Matrix, column k is y_k.
+//' @param lower Matrix, lower bounds of rho for each grid point (row).
+//' @param upper Matrix, upper bounds of rho for each grid point (row).
+//' @param tol Tolerance on the marginals and rho.
+//' @param max_iter Maximum number of iterations.
+//' @param nthreads Integer, number of threads.
+//' @return A list of eta, rho (matrix), number of iterations, status and the
+//'   Kullback-Leibler divergence for each grid point.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List solve_eta_grid_cpp(arma::vec s,
+                              arma::vec t,
+                              arma::mat x,
+                              arma::mat y,
+                              arma::mat lower,
+                              arma::mat upper,
+                              double tol,
+                              int max_iter,
+                              int nthreads) {
+  int ngrid = lower.n_rows, nk = x.n_cols;
+  std::vector<arma::mat> eta(ngrid, arma::mat(s.size(), t.size()));
+  arma::mat rho(ngrid, nk);
+  std::vector<std::string> status(ngrid);
+  std::vector<int> niter(ngrid);
+  int nblock = std::max(1, std::min(nthreads, ngrid));
+  #pragma omp parallel for num_threads(nthreads) schedule(static, 1)
+  for (int b = 0; b < nblock; b++) {
+    arma::vec lambda(nk, arma::fill::zeros), r(nk);
+    std::vector<double> lo(nk), hi(nk);
+    for (int g = b * ngrid / nblock; g < (b + 1) * ngrid / nblock; g++) {
+      for (int k = 0; k < nk; k++) {
+        lo[k] = lower(g, k);
+        hi[k] = upper(g, k);
+      }
+      status[g] = solveEta(s, t, x, y, lo, hi, tol, max_iter, nblock == 1,
+                           lambda, eta[g], r, &niter[g]);
+      if (status[g] != "optimal") {
+        // do not warm start from a failed solve
+        lambda.zeros();
+      }
+      for (int k = 0; k < nk; k++) {
+        rho(g, k) = r[k];
+      }
+    }
+  }
+  Rcpp::List eta_list(ngrid);
+  Rcpp::NumericVector value(ngrid);
+  for (int g = 0; g < ngrid; g++) {
+    eta_list[g] = eta[g];
+    value[g] = divergence(eta[g], s, t);
+  }
+  Rcpp::List ret;
+  ret["eta"] = eta_list;
+  ret["rho"] = rho;
+  ret["num_iters"] = niter;
+  ret["status"] = status;
+  ret["value"] = value;
+  return ret;
+}
@@ -1,5 +1,260 @@
 #include <RcppArmadillo.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "file_closer.h"
 // [[Rcpp::depends(RcppArmadillo)]]
+
+// Uniform random number from a splitmix64 stream. Used by the parallel
+// rewiring mode, where each thread owns a stream seeded from R's RNG.
+static inline double unifStream(uint64_t *state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+  return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Seed one stream per thread from R's RNG.
+static void seedStreams(std::vector<uint64_t> &state) {
+  for (size_t k = 0; k < state.size(); k++) {
+    state[k] = ((uint64_t) (unif_rand() * 4294967296.0) << 32) ^
+      (uint64_t) (unif_rand() * 4294967296.0);
+  }
+}
+
+// Draw 2 * npair distinct edges into the first 2 * npair elements of perm
+// with a partial Fisher-Yates shuffle. Consecutive elements form disjoint
+// edge pairs.
+static void drawEdgePairs(std::vector<int> &perm, int npair) {
+  int nedge = perm.size(), j, temp;
+  for (int k = 0; k < 2 * npair; k++) {
+    j = k + floor(unif_rand() * (nedge - k));
+    temp = perm[k];
+    perm[k] = perm[j];
+    perm[j] = temp;
+  }
+}
+
+// Pearson correlation from sums of x, y, x^2, y^2 and xy over n elements.
+static inline double corFromSums(double n, double sx, double sy,
+                                 double sxx, double syy, double sxy) {
+  return (n * sxy - sx * sy) / 
+    sqrt((n * sxx - sx * sx) * (n * syy - sy * sy));
+}
+
+// Target-side attributes of an edge in directed networks: target node,
+// index of its type in eta, out- and in-degree. An accepted rewiring attempt
+// exchanges two records.
+struct target_rec {
+  int node, index, out, in;
+};
+
+// An end of an edge in undirected networks: node, index of its degree in
+// eta and degree.
+struct end_rec {
+  int node, index, degree;
+};
+
+// Log of the target structure eta. Stored as a dense matrix if eta is small
+// or dense, otherwise as compressed sparse columns with sorted row indices.
+// Non-positive and unstored elements are -Inf.
+struct log_eta {
+  bool dense;
+  int nrow;
+  std::vector<double> value;
+  std::vector<int> colptr, rowind;
+  double operator()(int i, int j) const {
+    if (dense) {
+      return value[i + (size_t) j * nrow];
+    }
+    const int *first = rowind.data() + colptr[j];
+    const int *last = rowind.data() + colptr[j + 1];
+    const int *p = std::lower_bound(first, last, i);
+    return (p != last && *p == i) ? value[p - rowind.data()] : -INFINITY;
+  }
+};
+
+// Build the log of eta from eta in compressed sparse column format.
+static log_eta logEta(const arma::sp_mat &eta) {
+  log_eta ret;
+  double ncell = (double) eta.n_rows * eta.n_cols;
+  ret.nrow = eta.n_rows;
+  ret.dense = ncell <= 65536 || ncell <= 8.0 * eta.n_nonzero;
+  if (ret.dense) {
+    ret.value.assign(ncell, -INFINITY);
+  } else {
+    ret.value.resize(eta.n_nonzero);
+    ret.rowind.resize(eta.n_nonzero);
+    ret.colptr.assign(eta.col_ptrs, eta.col_ptrs + eta.n_cols + 1);
+  }
+  for (arma::uword j = 0; j < eta.n_cols; j++) {
+    for (arma::uword k = eta.col_ptrs[j]; k < eta.col_ptrs[j + 1]; k++) {
+      double x = eta.values[k] > 0 ? log(eta.values[k]) : -INFINITY;
+      if (ret.dense) {
+        ret.value[eta.row_indices[k] + j * eta.n_rows] = x;
+      } else {
+        ret.value[k] = x;
+        ret.rowind[k] = eta.row_indices[k];
+      }
+    }
+  }
+  return ret;
+}
+
+// Metropolis acceptance in log scale. A move that does not decrease the
+// probability is accepted, including a move from a state with probability
+// zero; a move to a state with probability zero is rejected.
+static inline bool acceptLog(double log_new, double log_old, double u) {
+  return (log_new >= log_old) || (log(u) <= log_new - log_old);
+}
+
+// Sink of the rewiring history. Each recorded attempt is a record of five
+// integers: iteration, attempt within the iteration, two sampled edges and
+// flags (1 if accepted, plus 2 for rewire type 2). Records are kept in
+// memory, or written to a binary file in chunks if a file is open. The file
+// is closed when the sink goes out of scope, including on user interrupts.
+struct history_sink {
+  bool active, accepted_only;
+  int nattempts, every;
+  file_closer file;
+  std::vector<int> record;
+};
+
+// Write buffered records to the file.
+static void flushHistory(history_sink &h) {
+  if (h.file.fp != NULL && h.record.size() > 0) {
+    if (fwrite(h.record.data(), sizeof(int), h.record.size(), h.file.fp) !=
+        h.record.size()) {
+      Rcpp::stop("Failed to write history file.");
+    }
+    h.record.clear();
+  }
+}
+
+// Open the history sink. The file consists of an 8-byte magic string
+// "WDNETHST" and four int32 values (format version, whether the network is
+// directed, nattempts and the sampling interval), followed by the records.
+// Native byte order is used.
+static void openHistory(history_sink &h, bool active, std::string file,
+                        int nattempts, int every, bool accepted_only,
+                        int directed) {
+  h.active = active;
+  h.accepted_only = accepted_only;
+  h.nattempts = nattempts;
+  h.every = every;
+  if (active && file.size() > 0) {
+    h.file.fp = fopen(file.c_str(), "wb");
+    if (h.file.fp == NULL) {
+      Rcpp::stop("Cannot open history file.");
+    }
+    int header[4] = {1, directed, nattempts, every};
+    if (fwrite("WDNETHST", 1, 8, h.file.fp) != 8 ||
+        fwrite(header, sizeof(int), 4, h.file.fp) != 4) {
+      Rcpp::stop("Failed to write history file.");
+    }
+  }
+}
+
+// Record an attempt if it passes the sampling options.
+static inline void addHistory(history_sink &h, int n, int i, int e1, int e2,
+                              int type, bool accepted) {
+  if ((! h.active) || (h.accepted_only && ! accepted) ||
+      ((int64_t) n * h.nattempts + i) % h.every != 0) {
+    return;
+  }
+  int rec[5] = {n, i, e1, e2, accepted + 2 * type};
+  h.record.insert(h.record.end(), rec, rec + 5);
+  if (h.file.fp != NULL && h.record.size() >= 5 * 65536) {
+    flushHistory(h);
+  }
+}
+
+// Close the history sink, returns the records kept in memory as a five
+// column matrix. An error is raised if any write to the file failed.
+static Rcpp::IntegerMatrix closeHistory(history_sink &h) {
+  if (h.file.fp != NULL) {
+    flushHistory(h);
+    if (! closeFile(h.file)) {
+      Rcpp::stop("Failed to write history file.");
+    }
+  }
+  int nrec = h.record.size() / 5;
+  Rcpp::IntegerMatrix ret(nrec, 5);
+  for (int k = 0; k < nrec; k++) {
+    for (int l = 0; l < 5; l++) {
+      ret(k, l) = h.record[5 * k + l];
+    }
+  }
+  return ret;
+}
+
+// One rewiring attempt for directed networks, returns whether the attempt
+// is accepted. sxy accumulates the changes of the sums of sourceOut *
+// targetOut, sourceOut * targetIn, sourceIn * targetOut and sourceIn *
+// targetIn.
+static inline bool attemptDirected(int e1, int e2, double u,
+                                   std::vector<target_rec> &target,
+                                   arma::vec &sourceOut,
+                                   arma::vec &sourceIn,
+                                   arma::uvec &index_s,
+                                   const log_eta &logeta,
+                                   double *sxy) {
+  int s1, s2, t1, t2;
+  s1 = index_s[e1];
+  s2 = index_s[e2];
+  t1 = target[e1].index;
+  t2 = target[e2].index;
+  if (acceptLog(logeta(s1, t2) + logeta(s2, t1),
+                logeta(s1, t1) + logeta(s2, t2), u)) {
+    double dout = target[e2].out - target[e1].out;
+    double din = target[e2].in - target[e1].in;
+    sxy[0] += (sourceOut[e1] - sourceOut[e2]) * dout;
+    sxy[1] += (sourceOut[e1] - sourceOut[e2]) * din;
+    sxy[2] += (sourceIn[e1] - sourceIn[e2]) * dout;
+    sxy[3] += (sourceIn[e1] - sourceIn[e2]) * din;
+    std::swap(target[e1], target[e2]);
+    return true;
+  }
+  return false;
+}
+
+// One rewiring attempt for undirected networks, rewire type 1 if v < 0.5,
+// otherwise type 2. Ends of edge e are stored at 2 * e and 2 * e + 1.
+// Returns whether the attempt is accepted. sxy accumulates the change of the
+// sum of the degree products of edges.
+static inline bool attemptUndirected(int e1, int e2, double u, double v,
+                                     std::vector<end_rec> &end,
+                                     const log_eta &loge,
+                                     double *sxy) {
+  end_rec *a1 = &end[2 * e1], *b1 = &end[2 * e1 + 1];
+  end_rec *a2 = &end[2 * e2], *b2 = &end[2 * e2 + 1];
+  int s1, s2, t1, t2;
+  double log_old;
+  s1 = a1->index;
+  s2 = a2->index;
+  t1 = b1->index;
+  t2 = b2->index;
+  log_old = loge(s1, t1) + loge(s2, t2);
+  if (v < 0.5) {
+    if (acceptLog(loge(s1, t2) + loge(s2, t1), log_old, u)) {
+      *sxy += (double) (a1->degree - a2->degree) * (b2->degree - b1->degree);
+      std::swap(*b1, *b2);
+      return true;
+    }
+  } else {
+    if (acceptLog(loge(s1, s2) + loge(t1, t2), log_old, u)) {
+      *sxy += (double) (a1->degree - b2->degree) * (a2->degree - b1->degree);
+      std::swap(*b1, *a2);
+      return true;
+    }
+  }
+  return false;
+}
+
 //' Degree preserving rewiring process for directed networks.
 //'
 //' @param iteration Integer, number of iterations of nattempts rewiring attempts.
@@ -13,9 +268,17 @@
 //'   index_s/index_t bridges the indices of source/target nodes and the 
 //'   target structure eta.
 //' @param index_t Index of target nodes' out- and in-degree. 
-//' @param eta Matrix, target structure eta generated by
+//' @param eta Sparse matrix, target structure eta generated by
 //'   \code{wdnet::get_eta_directed()}.
 //' @param rewire_history Logical, whether the rewiring history should be returned.
+//' @param history_file File name, if not empty, the rewiring history is
+//'   written to this binary file instead of being returned.
+//' @param history_every Integer, only every history_every-th attempt is
+//'   recorded.
+//' @param history_accepted Logical, whether only accepted attempts are
+//'   recorded.
+//' @param nthreads Integer, number of threads. If greater than 1, each batch
+//'   of attempts works on disjoint edge pairs that are evaluated in parallel.
 //' @return Target node sequence, four directed assortativity coefficients after
 //'   each iteration, and rewire history.
 //'
@@ -32,8 +295,12 @@ Rcpp::List dprewire_directed_cpp(
     arma::vec targetIn,
     arma::uvec index_s,
     arma::uvec index_t,
-    arma::mat eta, 
-    bool rewire_history) {
+    arma::sp_mat eta, 
+    bool rewire_history,
+    std::string history_file,
+    int history_every,
+    bool history_accepted,
+    int nthreads) {
   GetRNGstate();
   arma::vec out_out(iteration, arma::fill::zeros);
   arma::vec out_in(iteration, arma::fill::zeros);
@@ -44,68 +311,99 @@ Rcpp::List dprewire_directed_cpp(
   // arma::vec r_in_out(iteration, arma::fill::zeros);
   // arma::vec r_in_in(iteration, arma::fill::zeros);
   int nedge = targetNode.size();
-  int e1, e2, count = 0;
-  int s1, s2, t1, t2, hist_row;
-  double u, ratio, temp;
-  if (rewire_history) {
-    hist_row = iteration * nattempts;
-  } else {
-    hist_row = 1;
+  int e1, e2, npair;
+  double u;
+  history_sink history;
+  openHistory(history, rewire_history, history_file, nattempts,
+              history_every, history_accepted, 1);
+  // assortativity coefficients are tracked through the sums of cross
+  // products, other sums do not change since rewiring permutes the targets
+  double nn = nedge, sxy[4];
+  double so = arma::accu(sourceOut), si = arma::accu(sourceIn);
+  double to = arma::accu(targetOut), ti = arma::accu(targetIn);
+  double soso = arma::dot(sourceOut, sourceOut);
+  double sisi = arma::dot(sourceIn, sourceIn);
+  double toto = arma::dot(targetOut, targetOut);
+  double titi = arma::dot(targetIn, targetIn);
+  sxy[0] = arma::dot(sourceOut, targetOut);
+  sxy[1] = arma::dot(sourceOut, targetIn);
+  sxy[2] = arma::dot(sourceIn, targetOut);
+  sxy[3] = arma::dot(sourceIn, targetIn);
+  log_eta logeta = logEta(eta);
+  std::vector<target_rec> target(nedge);
+  for (int k = 0; k < nedge; k++) {
+    target[k].node = targetNode[k];
+    target[k].index = index_t[k];
+    target[k].out = targetOut[k];
+    target[k].in = targetIn[k];
+  }
+  std::vector<int> perm;
+  std::vector<uint64_t> stream;
+  std::vector<char> accepted;
+  // a batch needs at least one pair of distinct edges
+  if (nedge < 2) {
+    nthreads = 1;
+  }
+  if (nthreads > 1) {
+    accepted.resize(nedge / 2);
+    perm.resize(nedge);
+    for (int k = 0; k < nedge; k++) {
+      perm[k] = k;
+    }
+    stream.resize(nthreads);
   }
-  arma::mat history(hist_row, 4, arma::fill::zeros);
   for (int n = 0; n < iteration; n++) {
-    for (int i = 0; i < nattempts; i++) {
-      e1 = floor(unif_rand() * nedge);
-      e2 = floor(unif_rand() * nedge);
-      while (e1 == e2) {
-        e2 = floor(unif_rand() * nedge);
-      }
-      if (rewire_history) {
-        history(count, 0) = count;
-        history(count, 1) = e1;
-        history(count, 2) = e2;
-      }
-      s1 = index_s[e1];
-      s2 = index_s[e2];
-      t1 = index_t[e1];
-      t2 = index_t[e2];
-      if ((eta(s1, t2) * eta(s2, t1)) < (eta(s1, t1) * eta(s2, t2))) {
-        ratio = eta(s1, t2) * eta(s2, t1) / 
-          (eta(s1, t1) * eta(s2, t2));
-      }
-      else {
-        ratio = 1;
+    if (nthreads > 1) {
+      // attempts in a batch work on disjoint edge pairs, thus they can be
+      // evaluated in any order
+      for (int i = 0; i < nattempts; i += npair) {
+        npair = std::min(nedge / 2, nattempts - i);
+        drawEdgePairs(perm, npair);
+        seedStreams(stream);
+        #pragma omp parallel num_threads(nthreads)
+        {
+          int tid = 0;
+          #ifdef _OPENMP
+          tid = omp_get_thread_num();
+          #endif
+          uint64_t state = stream[tid];
+          double local_sxy[4] = {0, 0, 0, 0};
+          #pragma omp for schedule(static)
+          for (int k = 0; k < npair; k++) {
+            int f1 = perm[2 * k], f2 = perm[2 * k + 1];
+            accepted[k] = attemptDirected(f1, f2, unifStream(&state),
+                                          target, sourceOut, sourceIn,
+                                          index_s, logeta, local_sxy);
+          }
+          #pragma omp critical
+          {
+            for (int l = 0; l < 4; l++) {
+              sxy[l] += local_sxy[l];
+            }
+          }
+        }
+        for (int k = 0; k < npair; k++) {
+          addHistory(history, n, i + k, perm[2 * k], perm[2 * k + 1], 0,
+                     accepted[k]);
+        }
       }
-      u = unif_rand();
-      if (u <= ratio) {
-        temp = index_t[e1];
-        index_t[e1] = index_t[e2];
-        index_t[e2] = temp;
-        temp = targetNode[e1];
-        targetNode[e1] = targetNode[e2];
-        targetNode[e2] = temp;
-        temp = targetOut[e1];
-        targetOut[e1] = targetOut[e2];
-        targetOut[e2] = temp;
-        temp = targetIn[e1];
-        targetIn[e1] = targetIn[e2];
-        targetIn[e2] = temp;
-        // temp = r_targetOut[e1];
-        // r_targetOut[e1] = r_targetOut[e2];
-        // r_targetOut[e2] = temp;
-        // temp = r_targetIn[e1];
-        // r_targetIn[e1] = r_targetIn[e2];
-        // r_targetIn[e2] = temp;
-        if (rewire_history) {
-          history(count, 3) = 1;
+    } else {
+      for (int i = 0; i < nattempts; i++) {
+        e1 = floor(unif_rand() * nedge);
+        e2 = floor(unif_rand() * nedge);
+        while (e1 == e2) {
+          e2 = floor(unif_rand() * nedge);
         }
+        u = unif_rand();
+        addHistory(history, n, i, e1, e2, 0,
+                   attemptDirected(e1, e2, u, target, sourceOut, sourceIn,
+                                   index_s, logeta, sxy));
       }
-      count++;
     }
-    out_out[n] = (arma::cor(sourceOut, targetOut)).eval()(0, 0);
-    out_in[n] = (arma::cor(sourceOut, targetIn)).eval()(0, 0);
-    in_out[n] = (arma::cor(sourceIn, targetOut)).eval()(0, 0);
-    in_in[n] = (arma::cor(sourceIn, targetIn)).eval()(0, 0);
+    out_out[n] = corFromSums(nn, so, to, soso, toto, sxy[0]);
+    out_in[n] = corFromSums(nn, so, ti, soso, titi, sxy[1]);
+    in_out[n] = corFromSums(nn, si, to, sisi, toto, sxy[2]);
+    in_in[n] = corFromSums(nn, si, ti, sisi, titi, sxy[3]);
     // r_out_out[n] = (arma::cor(r_sourceOut, r_targetOut)).eval()(0, 0);
     // r_out_in[n] = (arma::cor(r_sourceOut, r_targetIn)).eval()(0, 0);
     // r_in_out[n] = (arma::cor(r_sourceIn, r_targetOut)).eval()(0, 0);
@@ -113,10 +411,13 @@ Rcpp::List dprewire_directed_cpp(
   }
   
   PutRNGstate();
+  for (int k = 0; k < nedge; k++) {
+    targetNode[k] = target[k].node;
+  }
   Rcpp::List ret;
   ret["targetNode"] = targetNode;
   if (rewire_history) {
-    ret["history"] = history;
+    ret["history"] = closeHistory(history);
   }
   ret["out_out"] = out_out;
   ret["out_in"] = out_in;
@@ -143,9 +444,17 @@ Rcpp::List dprewire_directed_cpp(
 //'   index1 and index2 bridge the nodes' degree and the 
 //'   structure e.
 //' @param index2 Index of the second column of edgelist..
-//' @param e Matrix, target structure e (eta) generated by
+//' @param e Sparse matrix, target structure e (eta) generated by
 //'   \code{wdnet::get_eta_undirected()}.
 //' @param rewire_history Logical, whether the rewiring history should be returned.
+//' @param history_file File name, if not empty, the rewiring history is
+//'   written to this binary file instead of being returned.
+//' @param history_every Integer, only every history_every-th attempt is
+//'   recorded.
+//' @param history_accepted Logical, whether only accepted attempts are
+//'   recorded.
+//' @param nthreads Integer, number of threads. If greater than 1, each batch
+//'   of attempts works on disjoint edge pairs that are evaluated in parallel.
 //' @return Node sequences, assortativity coefficient after each iteration
 //'   and rewiring history.
 //'
@@ -161,104 +470,108 @@ Rcpp::List dprewire_undirected_cpp(
     arma::vec degree2,
     arma::vec index1,
     arma::vec index2,
-    arma::mat e, 
-    bool rewire_history) {
+    arma::sp_mat e, 
+    bool rewire_history,
+    std::string history_file,
+    int history_every,
+    bool history_accepted,
+    int nthreads) {
   GetRNGstate();
   arma::vec rho(iteration, arma::fill::zeros);
   int nedge = index1.size();
-  int e1, e2, temp, count = 0;
-  int s1, s2, t1, t2, hist_row;
-  double u, v, ratio;
-  if (rewire_history) {
-    hist_row = iteration * nattempts;
-  } else {
-    hist_row = 1;
+  int e1, e2, npair;
+  double u, v;
+  history_sink history;
+  openHistory(history, rewire_history, history_file, nattempts,
+              history_every, history_accepted, 0);
+  // degree1 and degree2 are the same up to a permutation, the assortativity
+  // coefficient is tracked through the sum of degree1 * degree2 over the
+  // first nedge elements, i.e., half of the sum of cross products
+  double nn = 2.0 * nedge;
+  double sx = arma::accu(degree1), sxx = arma::dot(degree1, degree1);
+  double sxy = arma::dot(degree1.head(nedge), degree2.head(nedge));
+  log_eta loge = logEta(e);
+  std::vector<end_rec> end(2 * nedge);
+  for (int k = 0; k < nedge; k++) {
+    end[2 * k].node = node1[k];
+    end[2 * k].index = index1[k];
+    end[2 * k].degree = degree1[k];
+    end[2 * k + 1].node = node2[k];
+    end[2 * k + 1].index = index2[k];
+    end[2 * k + 1].degree = degree2[k];
+  }
+  std::vector<int> perm;
+  std::vector<uint64_t> stream;
+  std::vector<char> accepted, type;
+  // a batch needs at least one pair of distinct edges
+  if (nedge < 2) {
+    nthreads = 1;
+  }
+  if (nthreads > 1) {
+    accepted.resize(nedge / 2);
+    type.resize(nedge / 2);
+    perm.resize(nedge);
+    for (int k = 0; k < nedge; k++) {
+      perm[k] = k;
+    }
+    stream.resize(nthreads);
   }
-  arma::mat history(hist_row, 5, arma::fill::zeros);
   
   for (int n = 0; n < iteration; n++) {
-    for (int i = 0; i < nattempts; i++) {
-      e1 = floor(unif_rand() * nedge);
-      e2 = floor(unif_rand() * nedge);
-      while (e1 == e2) {
-        e2 = floor(unif_rand() * nedge);
-      }
-      if (rewire_history) {
-        history(count, 0) = count;
-        history(count, 1) = e1;
-        history(count, 2) = e2;
-      }
-      s1 = index1[e1];
-      s2 = index1[e2];
-      t1 = index2[e1];
-      t2 = index2[e2];
-      v = unif_rand();
-      u = unif_rand();
-      if (v < 0.5) {
-        // if (rewire_history) {
-        //   history(count, 3) = 0;
-        // }
-        if ((e(s1, t2) * e(s2, t1)) < (e(s1, t1) * e(s2, t2))) {
-          ratio = e(s1, t2) * e(s2, t1) / 
-            (e(s1, t1) * e(s2, t2));
-        }
-        else {
-          ratio = 1;
-        }
-        if (u <= ratio) {
-          if (rewire_history) {
-            history(count, 4) = 1;
+    if (nthreads > 1) {
+      // attempts in a batch work on disjoint edge pairs, thus they can be
+      // evaluated in any order
+      for (int i = 0; i < nattempts; i += npair) {
+        npair = std::min(nedge / 2, nattempts - i);
+        drawEdgePairs(perm, npair);
+        seedStreams(stream);
+        #pragma omp parallel num_threads(nthreads)
+        {
+          int tid = 0;
+          #ifdef _OPENMP
+          tid = omp_get_thread_num();
+          #endif
+          uint64_t state = stream[tid];
+          double local_sxy = 0;
+          #pragma omp for schedule(static)
+          for (int k = 0; k < npair; k++) {
+            int f1 = perm[2 * k], f2 = perm[2 * k + 1];
+            double fv = unifStream(&state);
+            type[k] = fv >= 0.5;
+            accepted[k] = attemptUndirected(f1, f2, unifStream(&state), fv,
+                                            end, loge, &local_sxy);
           }
-          temp = index2[e1];
-          index2[e1] = index2[e2];
-          index2[e2] = temp;
-          temp = node2[e1];
-          node2[e1] = node2[e2];
-          node2[e2] = temp;
-          temp = degree2[e1];
-          degree2[e1] = degree2[e2];
-          degree2[e2] = temp;
-          temp = degree1[e1 + nedge];
-          degree1[e1 + nedge] = degree1[e2 + nedge];
-          degree1[e2 + nedge] = temp;
-        }
-      } else {
-        if (rewire_history) {
-          history(count, 3) = 1;
+          #pragma omp atomic
+          sxy += local_sxy;
         }
-        if ((e(s1, s2) * e(t1, t2)) < (e(s1, t1) * e(s2, t2))) {
-          ratio = e(s1, s2) * e(t1, t2) / 
-            (e(s1, t1) * e(s2, t2));
+        for (int k = 0; k < npair; k++) {
+          addHistory(history, n, i + k, perm[2 * k], perm[2 * k + 1],
+                     type[k], accepted[k]);
         }
-        else {
-          ratio = 1;
-        }
-        if (u <= ratio) {
-          if (rewire_history) {
-            history(count, 4) = 1;
-          }
-          temp = index2[e1];
-          index2[e1] = index1[e2];
-          index1[e2] = temp;
-          temp = node2[e1];
-          node2[e1] = node1[e2];
-          node1[e2] = temp;
-          temp = degree2[e1];
-          degree2[e1] = degree1[e2];
-          degree1[e2] = temp;
-          temp = degree1[e1 + nedge];
-          degree1[e1 + nedge] = degree2[e2 + nedge];
-          degree2[e2 + nedge] = temp;
+      }
+    } else {
+      for (int i = 0; i < nattempts; i++) {
+        e1 = floor(unif_rand() * nedge);
+        e2 = floor(unif_rand() * nedge);
+        while (e1 == e2) {
+          e2 = floor(unif_rand() * nedge);
         }
+        v = unif_rand();
+        u = unif_rand();
+        addHistory(history, n, i, e1, e2, v >= 0.5,
+                   attemptUndirected(e1, e2, u, v, end, loge, &sxy));
       }
-      count++;
     }
-    rho[n] = (arma::cor(degree1, degree2)).eval()(0, 0);
+    rho[n] = corFromSums(nn, sx, sx, sxx, sxx, 2 * sxy);
   }
   PutRNGstate();
+  for (int k = 0; k < nedge; k++) {
+    node1[k] = end[2 * k].node;
+    node2[k] = end[2 * k + 1].node;
+  }
   Rcpp::List ret;
   if (rewire_history) {
-    ret["history"] = history;
+    ret["history"] = closeHistory(history);
   }
   ret["node1"] = node1;
   ret["node2"] = node2;
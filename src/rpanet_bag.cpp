@@ -2,11 +2,13 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 
 //' Preferential attachment algorithm for simple situations, 
-//' i.e., edge weight equals to 1, number of new edges per step is 1.
+//' i.e., edge weight equals to 1. Edges added in the same step are sampled
+//' from the network as it was at the beginning of the step.
 //'
 //' @param snode Source nodes.
 //' @param tnode Target nodes.
 //' @param scenario Sequence of alpha, beta, gamma, xi, rho scenarios.
+//' @param m Number of new edges in each step.
 //' @param nnode Number of nodes in seed network.
 //' @param nedge Number of edges in seed network.
 //' @param delta_out Tuning parameter.
@@ -20,118 +22,124 @@
 Rcpp::List rpanet_bag_cpp(arma::vec snode,
                                arma::vec tnode,
                                arma::vec scenario,
+                               Rcpp::IntegerVector m,
                                int nnode,
                                int nedge,
                                double delta_out,
                                double delta_in, 
                                bool directed) {
   GetRNGstate();
-  int n = scenario.size();
+  int nstep = m.size();
   double u, v;
-  int j;
-  for (int i = 0; i < n; i++) {
-    j = scenario[i];
-    switch(j) {
-      case 1: {
-        u = unif_rand() * (nedge + nnode * delta_in);
-        if (u < nedge) {
-          if (directed) {
-            tnode[nedge] = tnode[floor(u)] ;
-          }
-          else {
-            v = unif_rand();
-            if (v <= 0.5) {
-              tnode[nedge] = snode[floor(u)];
-            } 
+  int i, j, k = 0, step_node, step_edge;
+  for (i = 0; i < nstep; i++) {
+    // freeze the bag, new nodes and edges are not sampled in the same step
+    step_node = nnode;
+    step_edge = nedge;
+    for (j = 0; j < m[i]; j++) {
+      switch((int) scenario[k]) {
+        case 1: {
+          u = unif_rand() * (step_edge + step_node * delta_in);
+          if (u < step_edge) {
+            if (directed) {
+              tnode[nedge] = tnode[floor(u)] ;
+            }
             else {
-              tnode[nedge] = tnode[floor(u)];
+              v = unif_rand();
+              if (v <= 0.5) {
+                tnode[nedge] = snode[floor(u)];
+              } 
+              else {
+                tnode[nedge] = tnode[floor(u)];
+              }
             }
           }
-        }
-        else {
-          tnode[nedge] = ceil((u - nedge) / delta_in);
-        }
-        nnode++;
-        snode[nedge] = nnode;
-        break;
-      }
-      case 2: {
-        u = unif_rand() * (nedge + nnode * delta_out);
-        if (u < nedge) {
-          if (directed) {
-            snode[nedge] = snode[floor(u)] ;
-          }
           else {
-            v = unif_rand();
-            if (v <= 0.5) {
-              snode[nedge] = snode[floor(u)];
-            } 
-            else {
-              snode[nedge] = tnode[floor(u)];
-            }
+            tnode[nedge] = ceil((u - step_edge) / delta_in);
           }
-        } 
-        else {
-          snode[nedge] = ceil((u - nedge) / delta_out);
+          nnode++;
+          snode[nedge] = nnode;
+          break;
         }
-        
-        u = unif_rand() * (nedge + nnode * delta_in);
-        if (u < nedge) {
-          if (directed) {
-            tnode[nedge] = tnode[floor(u)] ;
-          }
+        case 2: {
+          u = unif_rand() * (step_edge + step_node * delta_out);
+          if (u < step_edge) {
+            if (directed) {
+              snode[nedge] = snode[floor(u)] ;
+            }
+            else {
+              v = unif_rand();
+              if (v <= 0.5) {
+                snode[nedge] = snode[floor(u)];
+              } 
+              else {
+                snode[nedge] = tnode[floor(u)];
+              }
+            }
+          } 
           else {
-            v = unif_rand();
-            if (v <= 0.5) {
-              tnode[nedge] = snode[floor(u)];
-            } 
+            snode[nedge] = ceil((u - step_edge) / delta_out);
+          }
+          
+          u = unif_rand() * (step_edge + step_node * delta_in);
+          if (u < step_edge) {
+            if (directed) {
+              tnode[nedge] = tnode[floor(u)] ;
+            }
             else {
-              tnode[nedge] = tnode[floor(u)];
+              v = unif_rand();
+              if (v <= 0.5) {
+                tnode[nedge] = snode[floor(u)];
+              } 
+              else {
+                tnode[nedge] = tnode[floor(u)];
+              }
             }
+          } 
+          else {
+            tnode[nedge] = ceil((u - step_edge) / delta_in);
           }
-        } 
-        else {
-          tnode[nedge] = ceil((u - nedge) / delta_in);
+          break;
         }
-        break;
-      }
-      case 3: {
-        u = unif_rand() * (nedge + nnode * delta_out);
-        if (u < nedge) {
-          if (directed) {
-            snode[nedge] = snode[floor(u)] ;
-          }
-          else {
-            v = unif_rand();
-            if (v <= 0.5) {
-              snode[nedge] = snode[floor(u)];
-            } 
+        case 3: {
+          u = unif_rand() * (step_edge + step_node * delta_out);
+          if (u < step_edge) {
+            if (directed) {
+              snode[nedge] = snode[floor(u)] ;
+            }
             else {
-              snode[nedge] = tnode[floor(u)];
+              v = unif_rand();
+              if (v <= 0.5) {
+                snode[nedge] = snode[floor(u)];
+              } 
+              else {
+                snode[nedge] = tnode[floor(u)];
+              }
             }
+          } 
+          else {
+            snode[nedge] = ceil((u - step_edge) / delta_out);
           }
-        } 
-        else {
-          snode[nedge] = ceil((u - nedge) / delta_out);
+          nnode++;
+          tnode[nedge] = nnode;
+          break;
+        }
+        case 4: {
+          nnode += 2;
+          snode[nedge] = nnode - 1;
+          tnode[nedge] = nnode;
+          break;
+        }
+        case 5: {
+          nnode++;
+          snode[nedge] = nnode;
+          tnode[nedge] = nnode;
+          break;
         }
-        nnode++;
-        tnode[nedge] = nnode;
-        break;
-      }
-      case 4: {
-        nnode += 2;
-        snode[nedge] = nnode - 1;
-        tnode[nedge] = nnode;
-        break;
-      }
-      case 5: {
-        nnode++;
-        snode[nedge] = nnode;
-        tnode[nedge] = nnode;
-        break;
       }
+      nedge++;
+      k++;
     }
-    nedge++;
   }
   PutRNGstate();
   
@@ -3,6 +3,7 @@
 #include <R.h>
 #include <Rcpp.h>
 #include "rpanet_binary_linear.h"
+#include "assortativity.h"
 
 using namespace std;
 funcPtrD custmSourcePref;
@@ -259,18 +260,105 @@ node_d *sampleNodeD(node_d *root, char type)
   }
 }
 
+/**
+ * Write the tree to a checkpoint. Nodes are written in breadth-first order,
+ * which is the order they were inserted, thus the tree can be linked again
+ * from their positions.
+ *
+ * @param fp Checkpoint file.
+ * @param root Root node of the tree.
+ */
+void writeTreeD(FILE *fp, node_d *root)
+{
+  queue<node_d *> q;
+  q.push(root);
+  while (!q.empty())
+  {
+    node_d *node = q.front();
+    q.pop();
+    if (node->left != NULL)
+    {
+      q.push(node->left);
+    }
+    if (node->right != NULL)
+    {
+      q.push(node->right);
+    }
+    int id[2] = {node->id, node->group};
+    double rec[6] = {node->outs, node->ins, node->sourcep, node->targetp,
+                     node->total_sourcep, node->total_targetp};
+    writeCheckpoint(fp, id, 2);
+    writeCheckpoint(fp, rec, 6);
+  }
+}
+
+/**
+ * Read the tree from a checkpoint, see writeTreeD. The node at position k
+ * is the parent of the nodes at positions 2k + 1 and 2k + 2.
+ *
+ * @param fp Checkpoint file.
+ * @param nnode Number of nodes.
+ * @param q Sequence of nodes that have less than 2 children.
+ *
+ * @return Root node of the tree.
+ */
+node_d *readTreeD(FILE *fp, int nnode, queue<node_d *> &q)
+{
+  vector<node_d *> tree(nnode);
+  int id[2];
+  double rec[6];
+  for (int k = 0; k < nnode; k++)
+  {
+    readCheckpoint(fp, id, 2);
+    readCheckpoint(fp, rec, 6);
+    tree[k] = createNodeD(id[0]);
+    tree[k]->group = id[1];
+    tree[k]->outs = rec[0];
+    tree[k]->ins = rec[1];
+    tree[k]->sourcep = rec[2];
+    tree[k]->targetp = rec[3];
+    tree[k]->total_sourcep = rec[4];
+    tree[k]->total_targetp = rec[5];
+    if (k > 0)
+    {
+      tree[k]->parent = tree[(k - 1) / 2];
+      if (k % 2 == 1)
+      {
+        tree[k]->parent->left = tree[k];
+      }
+      else
+      {
+        tree[k]->parent->right = tree[k];
+      }
+    }
+  }
+  for (int k = (nnode - 1) / 2; k < nnode; k++)
+  {
+    q.push(tree[k]);
+  }
+  return tree[0];
+}
+
 //' Preferential attachment algorithm.
 //'
 //' @param nstep Number of steps.
 //' @param m Number of new edges in each step.
 //' @param new_node_id New node ID.
 //' @param new_edge_id New edge ID.
-//' @param source_node Sequence of source nodes.
-//' @param target_node Sequence of target nodes.
+//' @param seed_edgelist Edgelist of the initial network, node ids start
+//'   from 1.
 //' @param outs Sequence of out-strength.
 //' @param ins Sequence of in-strength.
 //' @param edgeweight Weight of existing and new edges.
-//' @param scenario Scenario of existing and new edges.
+//' @param store_edge Logical, whether to store the edgelist and scenario
+//'   of new edges. If FALSE, only the number of edges from each scenario
+//'   and the node attributes are tracked.
+//' @param edgelist_file If not empty, existing and new edges are written to
+//'   this binary file instead of being stored.
+//' @param assort_every If positive, assortativity coefficients are recorded
+//'   every assort_every steps and at the last step.
+//' @param checkpoint List of checkpoint options: "file", "every", "resume"
+//'   and "seed".
 //' @param sample_recip Logical, whether reciprocal edges will be added.
 //' @param node_group Sequence of node group.
 //' @param source_pref Sequence of node source preference.
@@ -286,12 +374,14 @@ Rcpp::List rpanet_binary_directed(
     Rcpp::IntegerVector m,
     int new_node_id,
     int new_edge_id,
-    Rcpp::IntegerVector source_node,
-    Rcpp::IntegerVector target_node,
+    Rcpp::IntegerMatrix seed_edgelist,
     Rcpp::NumericVector outs,
     Rcpp::NumericVector ins,
     Rcpp::NumericVector edgeweight,
-    Rcpp::IntegerVector scenario,
+    bool store_edge,
+    std::string edgelist_file,
+    int assort_every,
+    Rcpp::List checkpoint,
     bool sample_recip,
     Rcpp::IntegerVector node_group,
     Rcpp::NumericVector source_pref,
@@ -338,63 +428,127 @@ Rcpp::List rpanet_binary_directed(
   }
   }
 
+  // new edges are stored in place in the returned edgelist, node ids start
+  // from 1
+  int nedge_max = edgeweight.size();
+  int *seed_source = seed_edgelist.begin();
+  int *seed_target = seed_source + new_edge_id;
+  Rcpp::IntegerMatrix edgelist(store_edge ? nedge_max : 0, 2);
+  Rcpp::IntegerVector scenario(store_edge ? nedge_max : 0);
+  int *source_node = edgelist.begin();
+  int *target_node = source_node + edgelist.nrow();
+  if (store_edge)
+  {
+    std::copy(seed_source, seed_source + new_edge_id, source_node);
+    std::copy(seed_target, seed_target + new_edge_id, target_node);
+  }
+
   double u, p, temp_p;
   bool m_error;
-  int i, j, n_existing, current_scenario, n_reciprocal;
-  node_d *node1, *node2;
+  int i, j, n_existing, current_scenario, n_reciprocal, n_seednode;
+  node_d *node1, *node2, *root;
+  queue<node_d *> q, q1;
 
-  // re-order label nodes according to source preference and target preference
-  Rcpp::NumericVector temp_source_pref(new_node_id);
-  Rcpp::NumericVector temp_target_pref(new_node_id);
-  Rcpp::IntegerVector sorted_node = Rcpp::seq(0, new_node_id - 1);
-  if (func_type == 1)
+  // number of edges from each scenario, 0 for the initial network
+  Rcpp::IntegerVector scenario_count(7);
+  scenario_count[0] = new_edge_id;
+
+  // resume from a checkpoint
+  checkpoint_ctl ckp(checkpoint, CKP_BINARY_DIRECTED);
+  file_closer ckp_fp;
+  int start_step = 0;
+  if (ckp.resume)
   {
-    for (i = 0; i < new_node_id; i++)
-    {
-      temp_source_pref[i] = prefFuncD(outs[i], ins[i], sparams);
-      temp_target_pref[i] = prefFuncD(outs[i], ins[i], tparams);
-    }
+    start_step = beginResume(ckp_fp, ckp, nstep, outs.size(), nedge_max,
+                             new_node_id, new_edge_id, n_seednode,
+                             scenario_count, m.begin());
   }
-  else
+
+  // write edges to a file instead of storing them
+  file_closer edge_fp;
+  if (!edgelist_file.empty())
   {
-    for (i = 0; i < new_node_id; i++)
+    if (ckp.resume)
+    {
+      resumeEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id);
+    }
+    else
     {
-      temp_source_pref[i] = custmSourcePref(outs[i], ins[i]);
-      temp_target_pref[i] = custmTargetPref(outs[i], ins[i]);
+      openEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id,
+                   seed_source, seed_target, 1);
     }
   }
-  if (alpha < gamma)
+
+  if (ckp.resume)
   {
-    sort(sorted_node.begin(), sorted_node.end(),
-         [&](int k, int l){ return temp_source_pref[k] > temp_source_pref[l]; });
+    // load the tree without evaluating the preference functions
+    root = readTreeD(ckp_fp.fp, new_node_id, q);
+    closeFile(ckp_fp);
   }
   else
   {
-    sort(sorted_node.begin(), sorted_node.end(),
-         [&](int k, int l){ return temp_target_pref[k] > temp_target_pref[l]; });
-  }
+    // re-order label nodes according to source preference and target preference
+    Rcpp::NumericVector temp_source_pref(new_node_id);
+    Rcpp::NumericVector temp_target_pref(new_node_id);
+    Rcpp::IntegerVector sorted_node = Rcpp::seq(0, new_node_id - 1);
+    if (func_type == 1)
+    {
+      for (i = 0; i < new_node_id; i++)
+      {
+        temp_source_pref[i] = prefFuncD(outs[i], ins[i], sparams);
+        temp_target_pref[i] = prefFuncD(outs[i], ins[i], tparams);
+      }
+    }
+    else
+    {
+      for (i = 0; i < new_node_id; i++)
+      {
+        temp_source_pref[i] = custmSourcePref(outs[i], ins[i]);
+        temp_target_pref[i] = custmTargetPref(outs[i], ins[i]);
+      }
+    }
+    if (alpha < gamma)
+    {
+      sort(sorted_node.begin(), sorted_node.end(),
+           [&](int k, int l){ return temp_source_pref[k] > temp_source_pref[l]; });
+    }
+    else
+    {
+      sort(sorted_node.begin(), sorted_node.end(),
+           [&](int k, int l){ return temp_target_pref[k] > temp_target_pref[l]; });
+    }
 
-  // initialize a tree from the seed graph
-  j = sorted_node[0];
-  node_d *root = createNodeD(j);
-  root->outs = outs[j];
-  root->ins = ins[j];
-  root->group = node_group[j];
-  updatePrefD(root, func_type, sparams, tparams, custmSourcePref, custmTargetPref);
-  queue<node_d *> q, q1;
-  q.push(root);
-  for (int i = 1; i < new_node_id; i++)
-  {
-    j = sorted_node[i];
-    node1 = insertNodeD(q, j);
-    node1->outs = outs[j];
-    node1->ins = ins[j];
-    node1->group = node_group[j];
-    updatePrefD(node1, func_type, sparams, tparams, custmSourcePref, custmTargetPref);
+    // initialize a tree from the seed graph
+    j = sorted_node[0];
+    root = createNodeD(j);
+    root->outs = outs[j];
+    root->ins = ins[j];
+    root->group = node_group[j];
+    updatePrefD(root, func_type, sparams, tparams, custmSourcePref, custmTargetPref);
+    q.push(root);
+    for (int i = 1; i < new_node_id; i++)
+    {
+      j = sorted_node[i];
+      node1 = insertNodeD(q, j);
+      node1->outs = outs[j];
+      node1->ins = ins[j];
+      node1->group = node_group[j];
+      updatePrefD(node1, func_type, sparams, tparams, custmSourcePref, custmTargetPref);
+    }
   }
   // sample edges
+  // track the network for assortativity coefficients
+  assort_monitor monitor(true, store_edge ? source_node : NULL,
+                         store_edge ? target_node : NULL, edgeweight.begin());
+  if (assort_every > 0)
+  {
+    for (j = 0; j < new_edge_id; j++)
+    {
+      monitor.addEdge(j, seed_source[j] - 1, seed_target[j] - 1);
+    }
+  }
   GetRNGstate();
-  for (i = 0; i < nstep; i++)
+  for (i = start_step; i < nstep; i++)
   {
     n_reciprocal = 0;
     m_error = false;
@@ -578,9 +732,21 @@ Rcpp::List rpanet_binary_directed(
       }
       node1->outs += edgeweight[new_edge_id];
       node2->ins += edgeweight[new_edge_id];
-      source_node[new_edge_id] = node1->id;
-      target_node[new_edge_id] = node2->id;
-      scenario[new_edge_id] = current_scenario;
+      if (store_edge)
+      {
+        source_node[new_edge_id] = node1->id + 1;
+        target_node[new_edge_id] = node2->id + 1;
+        scenario[new_edge_id] = current_scenario;
+      }
+      else if (edge_fp.fp != NULL)
+      {
+        writeEdgeRecord(edge_fp.fp, node1->id, node2->id, current_scenario);
+      }
+      if (assort_every > 0)
+      {
+        monitor.addEdge(new_edge_id, node1->id, node2->id);
+      }
+      scenario_count[current_scenario]++;
       q1.push(node1);
       q1.push(node2);
       // handle reciprocal
@@ -595,9 +761,21 @@ Rcpp::List rpanet_binary_directed(
             n_reciprocal++;
             node2->outs += edgeweight[new_edge_id];
             node1->ins += edgeweight[new_edge_id];
-            source_node[new_edge_id] = node2->id;
-            target_node[new_edge_id] = node1->id;
-            scenario[new_edge_id] = 6;
+            if (store_edge)
+            {
+              source_node[new_edge_id] = node2->id + 1;
+              target_node[new_edge_id] = node1->id + 1;
+              scenario[new_edge_id] = 6;
+            }
+            else if (edge_fp.fp != NULL)
+            {
+              writeEdgeRecord(edge_fp.fp, node2->id, node1->id, 6);
+            }
+            if (assort_every > 0)
+            {
+              monitor.addEdge(new_edge_id, node2->id, node1->id);
+            }
+            scenario_count[6]++;
           }
         }
       }
@@ -615,8 +793,24 @@ Rcpp::List rpanet_binary_directed(
       updatePrefD(q1.front(), func_type, sparams, tparams, custmSourcePref, custmTargetPref);
       q1.pop();
     }
+    if (assort_every > 0 && ((i + 1) % assort_every == 0 || i == nstep - 1))
+    {
+      monitor.record(i + 1);
+    }
+    if (ckp.due(i + 1, nstep))
+    {
+      file_closer ckp_out;
+      beginCheckpoint(ckp_out, ckp, nstep, i + 1, new_node_id, new_edge_id,
+                      0, scenario_count, m.begin(), edge_fp.fp);
+      writeTreeD(ckp_out.fp, root);
+      endCheckpoint(ckp_out, ckp);
+    }
   }
   PutRNGstate();
+  if (edge_fp.fp != NULL)
+  {
+    closeEdgeFile(edge_fp, new_edge_id, &(edgeweight[0]));
+  }
   // free memory (queue)
   queue<node_d *>().swap(q);
   queue<node_d *>().swap(q1);
@@ -647,17 +841,36 @@ Rcpp::List rpanet_binary_directed(
   // free memory (queue)
   queue<node_d *>().swap(q);
 
+  // right-sized results, node ids and node groups start from 1
   Rcpp::List ret;
   ret["m"] = m;
   ret["nnode"] = new_node_id;
   ret["nedge"] = new_edge_id;
-  ret["node_vec1"] = source_node;
-  ret["node_vec2"] = target_node;
-  ret["outstrength"] = outs;
-  ret["instrength"] = ins;
-  ret["scenario"] = scenario;
-  ret["nodegroup"] = node_group;
-  ret["source_pref"] = source_pref;
-  ret["target_pref"] = target_pref;
+  if (store_edge)
+  {
+    storeEdges(ret, edgelist, edgeweight, scenario, new_edge_id);
+  }
+  ret["scenario_count"] = scenario_count;
+  if (assort_every > 0)
+  {
+    ret["assortcoef"] = monitor.result();
+  }
+  ret["outstrength"] = Rcpp::NumericVector(outs.begin(),
+                                           outs.begin() + new_node_id);
+  ret["instrength"] = Rcpp::NumericVector(ins.begin(),
+                                          ins.begin() + new_node_id);
+  ret["source_pref"] = Rcpp::NumericVector(source_pref.begin(),
+                                           source_pref.begin() + new_node_id);
+  ret["target_pref"] = Rcpp::NumericVector(target_pref.begin(),
+                                           target_pref.begin() + new_node_id);
+  if (sample_recip)
+  {
+    Rcpp::IntegerVector nodegroup(new_node_id);
+    for (i = 0; i < new_node_id; i++)
+    {
+      nodegroup[i] = node_group[i] + 1;
+    }
+    ret["nodegroup"] = nodegroup;
+  }
   return ret;
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stdio.h>
+#include <Rcpp.h>
+#include "file_closer.h"
 
 typedef double (*funcPtrUnd)(double x);
 
@@ -14,3 +17,71 @@ int sampleGroup(double *group_prob);
 
 int sampleNodeLinear(int n_existing, int n_seednode, double *pref,
                      double total_pref, int *sorted_node);
+
+void openEdgeFile(file_closer &ef, const char *file, int nedge,
+                  int *source_node, int *target_node, int directed);
+
+void writeEdgeRecord(FILE *fp, int source, int target, int scenario);
+
+void closeEdgeFile(file_closer &ef, int nedge, double *edgeweight);
+
+void resumeEdgeFile(file_closer &ef, const char *file, int nedge);
+
+// Checkpoint options of a driver. The state of the driver is written to
+// file every `every` steps; if resume is true, it is loaded from file before
+// the first step. seed is .Random.seed before the number of new edges and
+// the edge weights are drawn, it is kept in the checkpoint so that the
+// resumed simulation draws them again.
+struct checkpoint_ctl
+{
+  std::string file;
+  int driver, every;
+  bool resume;
+  Rcpp::IntegerVector seed;
+  checkpoint_ctl(Rcpp::List ctl, int driver);
+  bool due(int step, int nstep)
+  {
+    return every > 0 && step % every == 0 && step < nstep;
+  }
+};
+
+// Drivers that write checkpoints.
+enum
+{
+  CKP_BINARY_DIRECTED = 1,
+  CKP_BINARY_UNDIRECTED = 2,
+  CKP_LINEAR_DIRECTED = 3,
+  CKP_LINEAR_UNDIRECTED = 4
+};
+
+void beginCheckpoint(file_closer &cf, checkpoint_ctl &ckp, int nstep,
+                     int step, int nnode, int nedge, int nseed,
+                     Rcpp::IntegerVector scenario_count, int *m,
+                     FILE *edge_fp);
+
+void endCheckpoint(file_closer &cf, checkpoint_ctl &ckp);
+
+int beginResume(file_closer &cf, checkpoint_ctl &ckp, int nstep,
+                int nnode_max, int nedge_max, int &nnode, int &nedge,
+                int &nseed, Rcpp::IntegerVector scenario_count, int *m);
+
+// Write an array to a checkpoint, errors are checked by endCheckpoint.
+template <typename T>
+void writeCheckpoint(FILE *fp, const T *x, size_t n)
+{
+  fwrite(x, sizeof(T), n, fp);
+}
+
+// Read an array from a checkpoint.
+template <typename T>
+void readCheckpoint(FILE *fp, T *x, size_t n)
+{
+  if (fread(x, sizeof(T), n, fp) != n)
+  {
+    Rcpp::stop("Failed to read checkpoint.file.");
+  }
+}
+
+void storeEdges(Rcpp::List &ret, Rcpp::IntegerMatrix edgelist,
+                Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario,
+                int nedge);
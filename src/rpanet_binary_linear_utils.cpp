@@ -1,5 +1,10 @@
 # include <math.h>
+# include <stdint.h>
+# include <stdio.h>
+# include <string.h>
 # include <R.h>
+# include <Rcpp.h>
+# include "rpanet_binary_linear.h"
 
 
 /**
@@ -91,4 +96,327 @@ int sampleNodeLinear(int n_existing, int n_seednode, double *pref,
     // i = n_existing;
   }
   return j;
-}
\ No newline at end of file
+}
+
+/**
+ * Append an edge to a binary edgelist file.
+ *
+ * @param fp File pointer.
+ * @param source Source node (starts from 0).
+ * @param target Target node (starts from 0).
+ * @param scenario Scenario of the edge.
+ */
+void writeEdgeRecord(FILE *fp, int source, int target, int scenario)
+{
+  int record[3] = {source + 1, target + 1, scenario};
+  fwrite(record, sizeof(int), 3, fp);
+}
+
+/**
+ * Open a binary edgelist file and write the header and existing edges.
+ *
+ * The file consists of an 8-byte magic string "WDNETEDG", two int32 values
+ * (format version and whether the network is directed), the number of edges
+ * as an int64, one record of three int32 values (source node starts from 1,
+ * target node starts from 1 and scenario) for each edge, followed by the
+ * weights of all edges as doubles. Native byte order is used.
+ *
+ * @param ef Edgelist file, the file is closed when it goes out of scope.
+ * @param file File name.
+ * @param nedge Number of existing edges.
+ * @param source_node Sequence of source nodes (starts from 1).
+ * @param target_node Sequence of target nodes (starts from 1).
+ * @param directed Whether the network is directed.
+ */
+void openEdgeFile(file_closer &ef, const char *file, int nedge, int *source_node,
+                  int *target_node, int directed)
+{
+  int header[2] = {1, directed};
+  int64_t count = 0;
+  ef.fp = fopen(file, "wb");
+  if (ef.fp == NULL)
+  {
+    Rcpp::stop("Cannot open edgelist.file.");
+  }
+  setvbuf(ef.fp, NULL, _IOFBF, 1 << 20);
+  fwrite("WDNETEDG", 1, 8, ef.fp);
+  fwrite(header, sizeof(int), 2, ef.fp);
+  fwrite(&count, sizeof(int64_t), 1, ef.fp);
+  for (int i = 0; i < nedge; i++)
+  {
+    writeEdgeRecord(ef.fp, source_node[i] - 1, target_node[i] - 1, 0);
+  }
+}
+
+/**
+ * Write edge weights and the number of edges, then close a binary edgelist
+ * file. An error is raised if any write to the file failed.
+ *
+ * @param ef Edgelist file.
+ * @param nedge Number of edges.
+ * @param edgeweight Weight of edges.
+ */
+void closeEdgeFile(file_closer &ef, int nedge, double *edgeweight)
+{
+  int64_t count = nedge;
+  fwrite(edgeweight, sizeof(double), nedge, ef.fp);
+  fseek(ef.fp, 8 + 2 * sizeof(int), SEEK_SET);
+  fwrite(&count, sizeof(int64_t), 1, ef.fp);
+  if (! closeFile(ef))
+  {
+    Rcpp::stop("Failed to write edgelist.file.");
+  }
+}
+
+/**
+ * Reopen a binary edgelist file to continue a simulation from a checkpoint.
+ * Edges after the first nedge edges, e.g., written after the checkpoint,
+ * are overwritten.
+ *
+ * @param ef Edgelist file, the file is closed when it goes out of scope.
+ * @param file File name.
+ * @param nedge Number of edges at the checkpoint.
+ */
+void resumeEdgeFile(file_closer &ef, const char *file, int nedge)
+{
+  char magic[8];
+  ef.fp = fopen(file, "r+b");
+  if (ef.fp == NULL)
+  {
+    Rcpp::stop("Cannot open edgelist.file.");
+  }
+  setvbuf(ef.fp, NULL, _IOFBF, 1 << 20);
+  if (fread(magic, 1, 8, ef.fp) != 8 || memcmp(magic, "WDNETEDG", 8) != 0 ||
+      seekFile(ef.fp, 24 + 12 * (int64_t)nedge) != 0)
+  {
+    Rcpp::stop("edgelist.file is not the edgelist file of the checkpoint.");
+  }
+}
+
+/**
+ * Read the checkpoint options of a driver.
+ *
+ * @param ctl List of "file", "every", "resume" and "seed".
+ * @param driver Driver, one of the CKP_* constants.
+ */
+checkpoint_ctl::checkpoint_ctl(Rcpp::List ctl, int driver) : driver(driver)
+{
+  std::string f = ctl["file"];
+  file = f;
+  every = ctl["every"];
+  resume = ctl["resume"];
+  seed = ctl["seed"];
+}
+
+/**
+ * Start writing a checkpoint, the caller then writes the driver state and
+ * calls endCheckpoint. The checkpoint is written to a temporary file first,
+ * thus an interrupted write does not damage the previous checkpoint.
+ *
+ * The file consists of an 8-byte magic string "WDNETCKP", two int32 values
+ * (format version and driver), five int64 values (number of steps, number of
+ * finished steps, number of nodes, number of edges and number of seed nodes),
+ * the number of edges from each scenario as int64, the lengths of the two
+ * random number generator states as int32, the state before the number of
+ * new edges and the edge weights were drawn, the state at the checkpoint,
+ * the number of edges added in each finished step as int32, followed by the
+ * driver state. Native byte order is used. Edges are not included; they are
+ * kept in the edgelist file, if any, which is flushed here.
+ *
+ * @param cf Checkpoint file, the file is closed when it goes out of scope.
+ * @param ckp Checkpoint options.
+ * @param nstep Number of steps.
+ * @param step Number of finished steps.
+ * @param nnode Number of nodes.
+ * @param nedge Number of edges.
+ * @param nseed Number of seed nodes, used by the linear method.
+ * @param scenario_count Number of edges from each scenario.
+ * @param m Number of edges added in each step.
+ * @param edge_fp Edgelist file or NULL.
+ */
+void beginCheckpoint(file_closer &cf, checkpoint_ctl &ckp, int nstep,
+                     int step, int nnode, int nedge, int nseed,
+                     Rcpp::IntegerVector scenario_count, int *m,
+                     FILE *edge_fp)
+{
+  int header[2] = {1, ckp.driver};
+  int64_t count[12] = {nstep, step, nnode, nedge, nseed};
+  if (edge_fp != NULL && fflush(edge_fp) != 0)
+  {
+    Rcpp::stop("Failed to write edgelist.file.");
+  }
+  PutRNGstate();
+  Rcpp::IntegerVector rng = Rcpp::Environment::global_env()[".Random.seed"];
+  int len[2] = {(int)ckp.seed.size(), (int)rng.size()};
+  for (int k = 0; k < 7; k++)
+  {
+    count[5 + k] = scenario_count[k];
+  }
+  cf.fp = fopen((ckp.file + ".tmp").c_str(), "wb");
+  if (cf.fp == NULL)
+  {
+    Rcpp::stop("Cannot open checkpoint.file.");
+  }
+  setvbuf(cf.fp, NULL, _IOFBF, 1 << 20);
+  writeCheckpoint(cf.fp, "WDNETCKP", 8);
+  writeCheckpoint(cf.fp, header, 2);
+  writeCheckpoint(cf.fp, count, 12);
+  writeCheckpoint(cf.fp, len, 2);
+  writeCheckpoint(cf.fp, ckp.seed.begin(), len[0]);
+  writeCheckpoint(cf.fp, rng.begin(), len[1]);
+  writeCheckpoint(cf.fp, m, step);
+}
+
+/**
+ * Finish a checkpoint, the temporary file replaces the previous checkpoint.
+ * An error is raised if any write to the file failed.
+ *
+ * @param cf Checkpoint file.
+ * @param ckp Checkpoint options.
+ */
+void endCheckpoint(file_closer &cf, checkpoint_ctl &ckp)
+{
+  std::string tmp = ckp.file + ".tmp";
+  if (!closeFile(cf))
+  {
+    remove(tmp.c_str());
+    Rcpp::stop("Failed to write checkpoint.file.");
+  }
+#ifdef _WIN32
+  remove(ckp.file.c_str());
+#endif
+  if (rename(tmp.c_str(), ckp.file.c_str()) != 0)
+  {
+    Rcpp::stop("Failed to write checkpoint.file.");
+  }
+}
+
+/**
+ * Start resuming from a checkpoint, see beginCheckpoint. The random number
+ * generator state at the checkpoint is restored; the caller then reads the
+ * driver state.
+ *
+ * @param cf Checkpoint file, the file is closed when it goes out of scope.
+ * @param ckp Checkpoint options.
+ * @param nstep Number of steps.
+ * @param nnode_max Maximum number of nodes.
+ * @param nedge_max Maximum number of edges.
+ * @param nnode Number of nodes.
+ * @param nedge Number of edges.
+ * @param nseed Number of seed nodes.
+ * @param scenario_count Number of edges from each scenario.
+ * @param m Number of edges added in each step.
+ *
+ * @return Number of finished steps.
+ */
+int beginResume(file_closer &cf, checkpoint_ctl &ckp, int nstep,
+                int nnode_max, int nedge_max, int &nnode, int &nedge,
+                int &nseed, Rcpp::IntegerVector scenario_count, int *m)
+{
+  char magic[8];
+  int header[2], len[2];
+  int64_t count[12];
+  cf.fp = fopen(ckp.file.c_str(), "rb");
+  if (cf.fp == NULL)
+  {
+    Rcpp::stop("Cannot open checkpoint.file.");
+  }
+  setvbuf(cf.fp, NULL, _IOFBF, 1 << 20);
+  readCheckpoint(cf.fp, magic, 8);
+  readCheckpoint(cf.fp, header, 2);
+  readCheckpoint(cf.fp, count, 12);
+  readCheckpoint(cf.fp, len, 2);
+  if (memcmp(magic, "WDNETCKP", 8) != 0 || header[0] != 1 ||
+      header[1] != ckp.driver || count[0] != nstep || count[1] < 0 ||
+      count[1] > nstep || count[2] > nnode_max || count[3] > nedge_max ||
+      count[4] > count[2] || len[0] != ckp.seed.size() || len[1] < 0)
+  {
+    Rcpp::stop("checkpoint.file does not match the simulation.");
+  }
+  nnode = count[2];
+  nedge = count[3];
+  nseed = count[4];
+  for (int k = 0; k < 7; k++)
+  {
+    scenario_count[k] = count[5 + k];
+  }
+  Rcpp::IntegerVector rng(len[1]);
+  fseek(cf.fp, len[0] * sizeof(int), SEEK_CUR);
+  readCheckpoint(cf.fp, rng.begin(), len[1]);
+  readCheckpoint(cf.fp, m, count[1]);
+  Rcpp::Environment::global_env().assign(".Random.seed", rng);
+  return count[1];
+}
+
+//' Read the header of a checkpoint written by rpanet.
+//'
+//' @param file Checkpoint file.
+//' @return A list of the driver, the number of steps, the number of finished
+//'   steps, the number of nodes, the number of edges and .Random.seed before
+//'   the number of new edges and the edge weights were drawn.
+//'
+//' @keywords internal
+//'
+// [[Rcpp::export]]
+Rcpp::List rpanet_checkpoint_info_cpp(std::string file)
+{
+  char magic[8];
+  int header[2], len[2];
+  int64_t count[12];
+  file_closer cf(fopen(file.c_str(), "rb"));
+  if (cf.fp == NULL)
+  {
+    Rcpp::stop("Cannot open checkpoint.file.");
+  }
+  readCheckpoint(cf.fp, magic, 8);
+  readCheckpoint(cf.fp, header, 2);
+  if (memcmp(magic, "WDNETCKP", 8) != 0 || header[0] != 1)
+  {
+    Rcpp::stop("checkpoint.file is not a checkpoint of rpanet.");
+  }
+  readCheckpoint(cf.fp, count, 12);
+  readCheckpoint(cf.fp, len, 2);
+  Rcpp::IntegerVector seed(len[0]);
+  readCheckpoint(cf.fp, seed.begin(), len[0]);
+  return Rcpp::List::create(Rcpp::Named("driver") = header[1],
+                            Rcpp::Named("nstep") = (double)count[0],
+                            Rcpp::Named("step") = (double)count[1],
+                            Rcpp::Named("nnode") = (double)count[2],
+                            Rcpp::Named("nedge") = (double)count[3],
+                            Rcpp::Named("seed") = seed);
+}
+
+/**
+ * Add the edgelist, edge weights and edge scenarios to the results of a
+ * driver. They are allocated for all the edges that may be added and
+ * returned as they are if all of them are added, e.g., without reciprocal
+ * edges; otherwise the first nedge edges are copied.
+ *
+ * @param ret Results of the driver.
+ * @param edgelist Edgelist, node ids start from 1.
+ * @param edgeweight Weight of edges.
+ * @param scenario Scenario of edges.
+ * @param nedge Number of edges added.
+ */
+void storeEdges(Rcpp::List &ret, Rcpp::IntegerMatrix edgelist,
+                Rcpp::NumericVector edgeweight, Rcpp::IntegerVector scenario,
+                int nedge)
+{
+  int nedge_max = edgelist.nrow();
+  if (nedge == nedge_max)
+  {
+    ret["edgelist"] = edgelist;
+    ret["edgeweight"] = edgeweight;
+    ret["scenario"] = scenario;
+    return;
+  }
+  Rcpp::IntegerMatrix shrunk(nedge, 2);
+  std::copy(edgelist.begin(), edgelist.begin() + nedge, shrunk.begin());
+  std::copy(edgelist.begin() + nedge_max, edgelist.begin() + nedge_max + nedge,
+            shrunk.begin() + nedge);
+  ret["edgelist"] = shrunk;
+  ret["edgeweight"] = Rcpp::NumericVector(edgeweight.begin(),
+                                          edgeweight.begin() + nedge);
+  ret["scenario"] = Rcpp::IntegerVector(scenario.begin(),
+                                        scenario.begin() + nedge);
+}
@@ -3,6 +3,7 @@
 #include <R.h>
 #include <Rcpp.h>
 #include "rpanet_binary_linear.h"
+#include "assortativity.h"
 
 using namespace std;
 funcPtrUnd custmPref;
@@ -176,17 +177,98 @@ node_und *sampleNodeUnd(node_und *root)
   return findNode(root, w);
 }
 
+/**
+ * Write the tree to a checkpoint. Nodes are written in breadth-first order,
+ * which is the order they were inserted, thus the tree can be linked again
+ * from their positions.
+ *
+ * @param fp Checkpoint file.
+ * @param root Root node of the tree.
+ */
+void writeTreeUnd(FILE *fp, node_und *root)
+{
+  queue<node_und *> q;
+  q.push(root);
+  while (!q.empty())
+  {
+    node_und *node = q.front();
+    q.pop();
+    if (node->left != NULL)
+    {
+      q.push(node->left);
+    }
+    if (node->right != NULL)
+    {
+      q.push(node->right);
+    }
+    double rec[3] = {node->strength, node->p, node->totalp};
+    writeCheckpoint(fp, &(node->id), 1);
+    writeCheckpoint(fp, rec, 3);
+  }
+}
+
+/**
+ * Read the tree from a checkpoint, see writeTreeUnd. The node at position k
+ * is the parent of the nodes at positions 2k + 1 and 2k + 2.
+ *
+ * @param fp Checkpoint file.
+ * @param nnode Number of nodes.
+ * @param q Sequence of nodes that have less than 2 children.
+ *
+ * @return Root node of the tree.
+ */
+node_und *readTreeUnd(FILE *fp, int nnode, queue<node_und *> &q)
+{
+  vector<node_und *> tree(nnode);
+  int id;
+  double rec[3];
+  for (int k = 0; k < nnode; k++)
+  {
+    readCheckpoint(fp, &id, 1);
+    readCheckpoint(fp, rec, 3);
+    tree[k] = createNodeUnd(id);
+    tree[k]->strength = rec[0];
+    tree[k]->p = rec[1];
+    tree[k]->totalp = rec[2];
+    if (k > 0)
+    {
+      tree[k]->parent = tree[(k - 1) / 2];
+      if (k % 2 == 1)
+      {
+        tree[k]->parent->left = tree[k];
+      }
+      else
+      {
+        tree[k]->parent->right = tree[k];
+      }
+    }
+  }
+  for (int k = (nnode - 1) / 2; k < nnode; k++)
+  {
+    q.push(tree[k]);
+  }
+  return tree[0];
+}
+
 //' Preferential attachment algorithm.
 //'
 //' @param nstep Number of steps.
 //' @param m Number of new edges in each step.
 //' @param new_node_id New node ID.
 //' @param new_edge_id New edge ID.
-//' @param node_vec1 Sequence of nodes in the first column of edgelist.
-//' @param node_vec2 Sequence of nodes in the second column of edgelist.
+//' @param seed_edgelist Edgelist of the initial network, node ids start
+//'   from 1.
 //' @param strength Sequence of node strength.
 //' @param edgeweight Weight of existing and new edges.
-//' @param scenario Scenario of existing and new edges.
+//' @param store_edge Logical, whether to store the edgelist and scenario
+//'   of new edges. If FALSE, only the number of edges from each scenario
+//'   and the node attributes are tracked.
+//' @param edgelist_file If not empty, existing and new edges are written to
+//'   this binary file instead of being stored.
+//' @param assort_every If positive, assortativity coefficients are recorded
+//'   every assort_every steps and at the last step.
+//' @param checkpoint List of checkpoint options: "file", "every", "resume"
+//'   and "seed".
 //' @param pref Sequence of node preference.
 //' @param control List of controlling arguments.
 //' @return Sampled network.
@@ -199,11 +281,13 @@ Rcpp::List rpanet_binary_undirected_cpp(
     Rcpp::IntegerVector m,
     int new_node_id,
     int new_edge_id,
-    Rcpp::IntegerVector node_vec1,
-    Rcpp::IntegerVector node_vec2,
+    Rcpp::IntegerMatrix seed_edgelist,
     Rcpp::NumericVector strength,
     Rcpp::NumericVector edgeweight,
-    Rcpp::IntegerVector scenario,
+    bool store_edge,
+    std::string edgelist_file,
+    int assort_every,
+    Rcpp::List checkpoint,
     Rcpp::NumericVector pref,
     Rcpp::List control)
 {
@@ -234,48 +318,112 @@ Rcpp::List rpanet_binary_undirected_cpp(
   }
   }
 
+  // new edges are stored in place in the returned edgelist, node ids start
+  // from 1
+  int nedge_max = edgeweight.size();
+  int *seed_source = seed_edgelist.begin();
+  int *seed_target = seed_source + new_edge_id;
+  Rcpp::IntegerMatrix edgelist(store_edge ? nedge_max : 0, 2);
+  Rcpp::IntegerVector scenario(store_edge ? nedge_max : 0);
+  int *node_vec1 = edgelist.begin();
+  int *node_vec2 = node_vec1 + edgelist.nrow();
+  if (store_edge)
+  {
+    std::copy(seed_source, seed_source + new_edge_id, node_vec1);
+    std::copy(seed_target, seed_target + new_edge_id, node_vec2);
+  }
+
   double u, temp_p;
   bool m_error;
-  int i, j, n_existing, current_scenario;
-  node_und *node1, *node2;
+  int i, j, n_existing, current_scenario, n_seednode;
+  node_und *node1, *node2, *root;
+  queue<node_und *> q, q1;
 
-  // re-order label nodes according to source preference and target preference
-  Rcpp::NumericVector temp_pref(new_node_id);
-  Rcpp::IntegerVector sorted_node = Rcpp::seq(0, new_node_id - 1);
-  if (func_type == 1)
+  // number of edges from each scenario, 0 for the initial network
+  Rcpp::IntegerVector scenario_count(7);
+  scenario_count[0] = new_edge_id;
+
+  // resume from a checkpoint
+  checkpoint_ctl ckp(checkpoint, CKP_BINARY_UNDIRECTED);
+  file_closer ckp_fp;
+  int start_step = 0;
+  if (ckp.resume)
   {
-    for (i = 0; i < new_node_id; i++)
+    start_step = beginResume(ckp_fp, ckp, nstep, strength.size(), nedge_max,
+                             new_node_id, new_edge_id, n_seednode,
+                             scenario_count, m.begin());
+  }
+
+  // write edges to a file instead of storing them
+  file_closer edge_fp;
+  if (!edgelist_file.empty())
+  {
+    if (ckp.resume)
+    {
+      resumeEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id);
+    }
+    else
     {
-      temp_pref[i] = prefFuncUnd(strength[i], params);
+      openEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id,
+                   seed_source, seed_target, 0);
     }
   }
+
+  if (ckp.resume)
+  {
+    // load the tree without evaluating the preference function
+    root = readTreeUnd(ckp_fp.fp, new_node_id, q);
+    closeFile(ckp_fp);
+  }
   else
   {
-    for (i = 0; i < new_node_id; i++)
+    // re-order label nodes according to source preference and target preference
+    Rcpp::NumericVector temp_pref(new_node_id);
+    Rcpp::IntegerVector sorted_node = Rcpp::seq(0, new_node_id - 1);
+    if (func_type == 1)
     {
-      temp_pref[i] = custmPref(strength[i]);
+      for (i = 0; i < new_node_id; i++)
+      {
+        temp_pref[i] = prefFuncUnd(strength[i], params);
+      }
     }
-  }
-  sort(sorted_node.begin(), sorted_node.end(),
-       [&](int k, int l){ return temp_pref[k] > temp_pref[l]; });
+    else
+    {
+      for (i = 0; i < new_node_id; i++)
+      {
+        temp_pref[i] = custmPref(strength[i]);
+      }
+    }
+    sort(sorted_node.begin(), sorted_node.end(),
+         [&](int k, int l){ return temp_pref[k] > temp_pref[l]; });
 
-  // initialize a tree from seed graph
-  j = sorted_node[0];
-  node_und *root = createNodeUnd(j);
-  root->strength = strength[j];
-  updatePrefUnd(root, func_type, params, custmPref);
-  queue<node_und *> q, q1;
-  q.push(root);
-  for (i = 1; i < new_node_id; i++)
-  {
-    j = sorted_node[i];
-    node1 = insertNodeUnd(q, j);
-    node1->strength = strength[j];
-    updatePrefUnd(node1, func_type, params, custmPref);
+    // initialize a tree from seed graph
+    j = sorted_node[0];
+    root = createNodeUnd(j);
+    root->strength = strength[j];
+    updatePrefUnd(root, func_type, params, custmPref);
+    q.push(root);
+    for (i = 1; i < new_node_id; i++)
+    {
+      j = sorted_node[i];
+      node1 = insertNodeUnd(q, j);
+      node1->strength = strength[j];
+      updatePrefUnd(node1, func_type, params, custmPref);
+    }
   }
   // sample edges
+  // track the network for assortativity coefficients
+  assort_monitor monitor(false, store_edge ? node_vec1 : NULL,
+                         store_edge ? node_vec2 : NULL, edgeweight.begin());
+  if (assort_every > 0)
+  {
+    for (j = 0; j < new_edge_id; j++)
+    {
+      monitor.addEdge(j, seed_source[j] - 1, seed_target[j] - 1);
+    }
+  }
   GetRNGstate();
-  for (i = 0; i < nstep; i++)
+  for (i = start_step; i < nstep; i++)
   {
     m_error = false;
     n_existing = new_node_id;
@@ -384,9 +532,21 @@ Rcpp::List rpanet_binary_undirected_cpp(
       }
       node1->strength += edgeweight[new_edge_id];
       node2->strength += edgeweight[new_edge_id];
-      node_vec1[new_edge_id] = node1->id;
-      node_vec2[new_edge_id] = node2->id;
-      scenario[new_edge_id] = current_scenario;
+      if (store_edge)
+      {
+        node_vec1[new_edge_id] = node1->id + 1;
+        node_vec2[new_edge_id] = node2->id + 1;
+        scenario[new_edge_id] = current_scenario;
+      }
+      else if (edge_fp.fp != NULL)
+      {
+        writeEdgeRecord(edge_fp.fp, node1->id, node2->id, current_scenario);
+      }
+      if (assort_every > 0)
+      {
+        monitor.addEdge(new_edge_id, node1->id, node2->id);
+      }
+      scenario_count[current_scenario]++;
       q1.push(node1);
       q1.push(node2);
       new_edge_id++;
@@ -402,8 +562,24 @@ Rcpp::List rpanet_binary_undirected_cpp(
       updatePrefUnd(q1.front(), func_type, params, custmPref);
       q1.pop();
     }
+    if (assort_every > 0 && ((i + 1) % assort_every == 0 || i == nstep - 1))
+    {
+      monitor.record(i + 1);
+    }
+    if (ckp.due(i + 1, nstep))
+    {
+      file_closer ckp_out;
+      beginCheckpoint(ckp_out, ckp, nstep, i + 1, new_node_id, new_edge_id,
+                      0, scenario_count, m.begin(), edge_fp.fp);
+      writeTreeUnd(ckp_out.fp, root);
+      endCheckpoint(ckp_out, ckp);
+    }
   }
   PutRNGstate();
+  if (edge_fp.fp != NULL)
+  {
+    closeEdgeFile(edge_fp, new_edge_id, &(edgeweight[0]));
+  }
   // free memory (queue)
   queue<node_und *>().swap(q);
   queue<node_und *>().swap(q1);
@@ -431,14 +607,23 @@ Rcpp::List rpanet_binary_undirected_cpp(
   // free memory (queue)
   queue<node_und *>().swap(q);
 
+  // right-sized results, node ids and node groups start from 1
   Rcpp::List ret;
   ret["m"] = m;
   ret["nnode"] = new_node_id;
   ret["nedge"] = new_edge_id;
-  ret["node_vec1"] = node_vec1;
-  ret["node_vec2"] = node_vec2;
-  ret["pref"] = pref;
-  ret["strength"] = strength;
-  ret["scenario"] = scenario;
+  if (store_edge)
+  {
+    storeEdges(ret, edgelist, edgeweight, scenario, new_edge_id);
+  }
+  ret["scenario_count"] = scenario_count;
+  if (assort_every > 0)
+  {
+    ret["assortcoef"] = monitor.result();
+  }
+  ret["strength"] = Rcpp::NumericVector(strength.begin(),
+                                        strength.begin() + new_node_id);
+  ret["pref"] = Rcpp::NumericVector(pref.begin(),
+                                    pref.begin() + new_node_id);
   return ret;
 }
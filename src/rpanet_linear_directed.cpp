@@ -3,6 +3,7 @@
 #include <R.h>
 #include <Rcpp.h>
 #include "rpanet_binary_linear.h"
+#include "assortativity.h"
 
 using namespace std;
 funcPtrD custmSourcePrefLinear;
@@ -83,12 +84,20 @@ double calcPrefLinearD(int func_type,
 //' @param m Number of new edges in each step.
 //' @param new_node_id New node ID.
 //' @param new_edge_id New edge ID.
-//' @param source_node Sequence of source nodes.
-//' @param target_node Sequence of target nodes.
+//' @param seed_edgelist Edgelist of the initial network, node ids start
+//'   from 1.
 //' @param outs Sequence of out-strength.
 //' @param ins Sequence of in-strength.
 //' @param edgeweight Weight of existing and new edges.
-//' @param scenario Scenario of existing and new edges.
+//' @param store_edge Logical, whether to store the edgelist and scenario
+//'   of new edges. If FALSE, only the number of edges from each scenario
+//'   and the node attributes are tracked.
+//' @param edgelist_file If not empty, existing and new edges are written to
+//'   this binary file instead of being stored.
+//' @param assort_every If positive, assortativity coefficients are recorded
+//'   every assort_every steps and at the last step.
+//' @param checkpoint List of checkpoint options: "file", "every", "resume"
+//'   and "seed".
 //' @param sample_recip Logical, whether reciprocal edges will be added.
 //' @param node_group Sequence of node group.
 //' @param source_pref Sequence of node source preference.
@@ -104,12 +113,14 @@ Rcpp::List rpanet_linear_directed_cpp(
     Rcpp::IntegerVector m,
     int new_node_id,
     int new_edge_id,
-    Rcpp::IntegerVector source_node,
-    Rcpp::IntegerVector target_node,
+    Rcpp::IntegerMatrix seed_edgelist,
     Rcpp::NumericVector outs,
     Rcpp::NumericVector ins,
     Rcpp::NumericVector edgeweight,
-    Rcpp::IntegerVector scenario,
+    bool store_edge,
+    std::string edgelist_file,
+    int assort_every,
+    Rcpp::List checkpoint,
     bool sample_recip,
     Rcpp::IntegerVector node_group,
     Rcpp::NumericVector source_pref_vec,
@@ -158,32 +169,103 @@ Rcpp::List rpanet_linear_directed_cpp(
   }
   }
 
+  // new edges are stored in place in the returned edgelist, node ids start
+  // from 1
+  int nedge_max = edgeweight.size();
+  int *seed_source = seed_edgelist.begin();
+  int *seed_target = seed_source + new_edge_id;
+  Rcpp::IntegerMatrix edgelist(store_edge ? nedge_max : 0, 2);
+  Rcpp::IntegerVector scenario(store_edge ? nedge_max : 0);
+  int *source_node = edgelist.begin();
+  int *target_node = source_node + edgelist.nrow();
+  if (store_edge)
+  {
+    std::copy(seed_source, seed_source + new_edge_id, source_node);
+    std::copy(seed_target, seed_target + new_edge_id, target_node);
+  }
+
   double u, p, temp_p, total_source_pref = 0, total_target_pref = 0;
   bool m_error;
   int i, j, k, n_existing, current_scenario, n_reciprocal;
   int node1, node2, temp_node, n_seednode = new_node_id;
 
-  // sort nodes according to node preference
+  // number of edges from each scenario, 0 for the initial network
+  Rcpp::IntegerVector scenario_count(7);
+  scenario_count[0] = new_edge_id;
+
+  // resume from a checkpoint
+  checkpoint_ctl ckp(checkpoint, CKP_LINEAR_DIRECTED);
+  file_closer ckp_fp;
+  int start_step = 0;
+  if (ckp.resume)
+  {
+    start_step = beginResume(ckp_fp, ckp, nstep, outs.size(), nedge_max,
+                             new_node_id, new_edge_id, n_seednode,
+                             scenario_count, m.begin());
+  }
+
+  // write edges to a file instead of storing them
+  file_closer edge_fp;
+  if (!edgelist_file.empty())
+  {
+    if (ckp.resume)
+    {
+      resumeEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id);
+    }
+    else
+    {
+      openEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id,
+                   seed_source, seed_target, 1);
+    }
+  }
+
+  // sort nodes according to node preference, or load them from the
+  // checkpoint without evaluating the preference functions
   Rcpp::IntegerVector sorted_source_node_vec = Rcpp::seq(0, n_seednode - 1);
   Rcpp::IntegerVector sorted_target_node_vec = Rcpp::seq(0, n_seednode - 1);
-  for (int i = 0; i < new_node_id; i++)
+  if (ckp.resume)
+  {
+    readCheckpoint(ckp_fp.fp, outs.begin(), new_node_id);
+    readCheckpoint(ckp_fp.fp, ins.begin(), new_node_id);
+    readCheckpoint(ckp_fp.fp, source_pref, new_node_id);
+    readCheckpoint(ckp_fp.fp, target_pref, new_node_id);
+    readCheckpoint(ckp_fp.fp, node_group.begin(), new_node_id);
+    readCheckpoint(ckp_fp.fp, &total_source_pref, 1);
+    readCheckpoint(ckp_fp.fp, &total_target_pref, 1);
+    readCheckpoint(ckp_fp.fp, sorted_source_node_vec.begin(), n_seednode);
+    readCheckpoint(ckp_fp.fp, sorted_target_node_vec.begin(), n_seednode);
+    closeFile(ckp_fp);
+  }
+  else
   {
-    source_pref[i] = calcPrefLinearD(func_type, outs[i], ins[i], sparams, custmSourcePrefLinear);
-    target_pref[i] = calcPrefLinearD(func_type, outs[i], ins[i], tparams, custmTargetPrefLinear);
-    total_source_pref += source_pref[i];
-    total_target_pref += target_pref[i];
+    for (int i = 0; i < new_node_id; i++)
+    {
+      source_pref[i] = calcPrefLinearD(func_type, outs[i], ins[i], sparams, custmSourcePrefLinear);
+      target_pref[i] = calcPrefLinearD(func_type, outs[i], ins[i], tparams, custmTargetPrefLinear);
+      total_source_pref += source_pref[i];
+      total_target_pref += target_pref[i];
+    }
+    sort(sorted_source_node_vec.begin(), sorted_source_node_vec.end(),
+         [&](int k, int l){ return source_pref[k] > source_pref[l]; });
+    sort(sorted_target_node_vec.begin(), sorted_target_node_vec.end(),
+         [&](int k, int l){ return target_pref[k] > target_pref[l]; });
   }
-  sort(sorted_source_node_vec.begin(), sorted_source_node_vec.end(),
-       [&](int k, int l){ return source_pref[k] > source_pref[l]; });
-  sort(sorted_target_node_vec.begin(), sorted_target_node_vec.end(),
-       [&](int k, int l){ return target_pref[k] > target_pref[l]; });
   int *sorted_source_node = &(sorted_source_node_vec[0]);
   int *sorted_target_node = &(sorted_target_node_vec[0]);
-
   // sample edges
   queue<int> q1;
+  // track the network for assortativity coefficients
+  assort_monitor monitor(true, store_edge ? source_node : NULL,
+                         store_edge ? target_node : NULL, edgeweight.begin());
+  if (assort_every > 0)
+  {
+    for (j = 0; j < new_edge_id; j++)
+    {
+      monitor.addEdge(j, seed_source[j] - 1, seed_target[j] - 1);
+    }
+  }
   GetRNGstate();
-  for (i = 0; i < nstep; i++)
+  for (i = start_step; i < nstep; i++)
   {
     n_reciprocal = 0;
     m_error = false;
@@ -398,9 +480,21 @@ Rcpp::List rpanet_linear_directed_cpp(
       // checkDiffD(target_pref, total_target_pref);
       outs[node1] += edgeweight[new_edge_id];
       ins[node2] += edgeweight[new_edge_id];
-      source_node[new_edge_id] = node1;
-      target_node[new_edge_id] = node2;
-      scenario[new_edge_id] = current_scenario;
+      if (store_edge)
+      {
+        source_node[new_edge_id] = node1 + 1;
+        target_node[new_edge_id] = node2 + 1;
+        scenario[new_edge_id] = current_scenario;
+      }
+      else if (edge_fp.fp != NULL)
+      {
+        writeEdgeRecord(edge_fp.fp, node1, node2, current_scenario);
+      }
+      if (assort_every > 0)
+      {
+        monitor.addEdge(new_edge_id, node1, node2);
+      }
+      scenario_count[current_scenario]++;
       q1.push(node1);
       q1.push(node2);
       // handel reciprocal
@@ -415,9 +509,21 @@ Rcpp::List rpanet_linear_directed_cpp(
             n_reciprocal++;
             outs[node2] += edgeweight[new_edge_id];
             ins[node1] += edgeweight[new_edge_id];
-            source_node[new_edge_id] = node2;
-            target_node[new_edge_id] = node1;
-            scenario[new_edge_id] = 6;
+            if (store_edge)
+            {
+              source_node[new_edge_id] = node2 + 1;
+              target_node[new_edge_id] = node1 + 1;
+              scenario[new_edge_id] = 6;
+            }
+            else if (edge_fp.fp != NULL)
+            {
+              writeEdgeRecord(edge_fp.fp, node2, node1, 6);
+            }
+            if (assort_every > 0)
+            {
+              monitor.addEdge(new_edge_id, node2, node1);
+            }
+            scenario_count[6]++;
           }
         }
       }
@@ -443,20 +549,63 @@ Rcpp::List rpanet_linear_directed_cpp(
     }
     // checkDiffD(source_pref, total_source_pref);
     // checkDiffD(target_pref, total_target_pref);
+    if (assort_every > 0 && ((i + 1) % assort_every == 0 || i == nstep - 1))
+    {
+      monitor.record(i + 1);
+    }
+    if (ckp.due(i + 1, nstep))
+    {
+      file_closer ckp_out;
+      beginCheckpoint(ckp_out, ckp, nstep, i + 1, new_node_id, new_edge_id,
+                      n_seednode, scenario_count, m.begin(), edge_fp.fp);
+      writeCheckpoint(ckp_out.fp, outs.begin(), new_node_id);
+      writeCheckpoint(ckp_out.fp, ins.begin(), new_node_id);
+      writeCheckpoint(ckp_out.fp, source_pref, new_node_id);
+      writeCheckpoint(ckp_out.fp, target_pref, new_node_id);
+      writeCheckpoint(ckp_out.fp, node_group.begin(), new_node_id);
+      writeCheckpoint(ckp_out.fp, &total_source_pref, 1);
+      writeCheckpoint(ckp_out.fp, &total_target_pref, 1);
+      writeCheckpoint(ckp_out.fp, sorted_source_node, n_seednode);
+      writeCheckpoint(ckp_out.fp, sorted_target_node, n_seednode);
+      endCheckpoint(ckp_out, ckp);
+    }
   }
   PutRNGstate();
+  if (edge_fp.fp != NULL)
+  {
+    closeEdgeFile(edge_fp, new_edge_id, &(edgeweight[0]));
+  }
 
+  // right-sized results, node ids and node groups start from 1
   Rcpp::List ret;
   ret["m"] = m;
   ret["nnode"] = new_node_id;
   ret["nedge"] = new_edge_id;
-  ret["node_vec1"] = source_node;
-  ret["node_vec2"] = target_node;
-  ret["outstrength"] = outs;
-  ret["instrength"] = ins;
-  ret["scenario"] = scenario;
-  ret["nodegroup"] = node_group;
-  ret["source_pref"] = source_pref_vec;
-  ret["target_pref"] = target_pref_vec;
+  if (store_edge)
+  {
+    storeEdges(ret, edgelist, edgeweight, scenario, new_edge_id);
+  }
+  ret["scenario_count"] = scenario_count;
+  if (assort_every > 0)
+  {
+    ret["assortcoef"] = monitor.result();
+  }
+  ret["outstrength"] = Rcpp::NumericVector(outs.begin(),
+                                           outs.begin() + new_node_id);
+  ret["instrength"] = Rcpp::NumericVector(ins.begin(),
+                                          ins.begin() + new_node_id);
+  ret["source_pref"] = Rcpp::NumericVector(source_pref_vec.begin(),
+                                           source_pref_vec.begin() + new_node_id);
+  ret["target_pref"] = Rcpp::NumericVector(target_pref_vec.begin(),
+                                           target_pref_vec.begin() + new_node_id);
+  if (sample_recip)
+  {
+    Rcpp::IntegerVector nodegroup(new_node_id);
+    for (i = 0; i < new_node_id; i++)
+    {
+      nodegroup[i] = node_group[i] + 1;
+    }
+    ret["nodegroup"] = nodegroup;
+  }
   return ret;
 }
@@ -3,6 +3,7 @@
 #include <R.h>
 #include <Rcpp.h>
 #include "rpanet_binary_linear.h"
+#include "assortativity.h"
 
 using namespace std;
 funcPtrUnd custmPrefLinear;
@@ -80,11 +81,19 @@ double calcPrefLinearUnd(int func_type,
 //' @param m Number of new edges in each step.
 //' @param new_node_id New node ID.
 //' @param new_edge_id New edge ID.
-//' @param node_vec1 Sequence of nodes in the first column of edgelist.
-//' @param node_vec2 Sequence of nodes in the second column of edgelist.
+//' @param seed_edgelist Edgelist of the initial network, node ids start
+//'   from 1.
 //' @param strength Sequence of node strength.
 //' @param edgeweight Weight of existing and new edges.
-//' @param scenario Scenario of existing and new edges.
+//' @param store_edge Logical, whether to store the edgelist and scenario
+//'   of new edges. If FALSE, only the number of edges from each scenario
+//'   and the node attributes are tracked.
+//' @param edgelist_file If not empty, existing and new edges are written to
+//'   this binary file instead of being stored.
+//' @param assort_every If positive, assortativity coefficients are recorded
+//'   every assort_every steps and at the last step.
+//' @param checkpoint List of checkpoint options: "file", "every", "resume"
+//'   and "seed".
 //' @param pref Sequence of node preference.
 //' @param control List of controlling arguments.
 //' @return Sampled network.
@@ -97,11 +106,13 @@ Rcpp::List rpanet_linear_undirected_cpp(
     Rcpp::IntegerVector m,
     int new_node_id,
     int new_edge_id,
-    Rcpp::IntegerVector node_vec1,
-    Rcpp::IntegerVector node_vec2,
+    Rcpp::IntegerMatrix seed_edgelist,
     Rcpp::NumericVector strength,
     Rcpp::NumericVector edgeweight,
-    Rcpp::IntegerVector scenario,
+    bool store_edge,
+    std::string edgelist_file,
+    int assort_every,
+    Rcpp::List checkpoint,
     Rcpp::NumericVector pref_vec,
     Rcpp::List control)
 {
@@ -133,26 +144,92 @@ Rcpp::List rpanet_linear_undirected_cpp(
   }
   }
 
+  // new edges are stored in place in the returned edgelist, node ids start
+  // from 1
+  int nedge_max = edgeweight.size();
+  int *seed_source = seed_edgelist.begin();
+  int *seed_target = seed_source + new_edge_id;
+  Rcpp::IntegerMatrix edgelist(store_edge ? nedge_max : 0, 2);
+  Rcpp::IntegerVector scenario(store_edge ? nedge_max : 0);
+  int *node_vec1 = edgelist.begin();
+  int *node_vec2 = node_vec1 + edgelist.nrow();
+  if (store_edge)
+  {
+    std::copy(seed_source, seed_source + new_edge_id, node_vec1);
+    std::copy(seed_target, seed_target + new_edge_id, node_vec2);
+  }
+
   double u, total_pref = 0, temp_p;
   bool m_error;
   int i, j, k, n_existing, current_scenario;
   int node1, node2, temp_node, n_seednode = new_node_id;
 
-  // sort nodes according to node preference
+  // number of edges from each scenario, 0 for the initial network
+  Rcpp::IntegerVector scenario_count(7);
+  scenario_count[0] = new_edge_id;
+
+  // resume from a checkpoint
+  checkpoint_ctl ckp(checkpoint, CKP_LINEAR_UNDIRECTED);
+  file_closer ckp_fp;
+  int start_step = 0;
+  if (ckp.resume)
+  {
+    start_step = beginResume(ckp_fp, ckp, nstep, strength.size(), nedge_max,
+                             new_node_id, new_edge_id, n_seednode,
+                             scenario_count, m.begin());
+  }
+
+  // write edges to a file instead of storing them
+  file_closer edge_fp;
+  if (!edgelist_file.empty())
+  {
+    if (ckp.resume)
+    {
+      resumeEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id);
+    }
+    else
+    {
+      openEdgeFile(edge_fp, edgelist_file.c_str(), new_edge_id,
+                   seed_source, seed_target, 0);
+    }
+  }
+
+  // sort nodes according to node preference, or load them from the
+  // checkpoint without evaluating the preference function
   Rcpp::IntegerVector sorted_node_vec = Rcpp::seq(0, n_seednode - 1);
-  for (i = 0; i < new_node_id; i++)
+  if (ckp.resume)
+  {
+    readCheckpoint(ckp_fp.fp, strength.begin(), new_node_id);
+    readCheckpoint(ckp_fp.fp, pref, new_node_id);
+    readCheckpoint(ckp_fp.fp, &total_pref, 1);
+    readCheckpoint(ckp_fp.fp, sorted_node_vec.begin(), n_seednode);
+    closeFile(ckp_fp);
+  }
+  else
   {
-    pref[i] = calcPrefLinearUnd(func_type, strength[i], params, custmPrefLinear);
-    total_pref += pref[i];
+    for (i = 0; i < new_node_id; i++)
+    {
+      pref[i] = calcPrefLinearUnd(func_type, strength[i], params, custmPrefLinear);
+      total_pref += pref[i];
+    }
+    sort(sorted_node_vec.begin(), sorted_node_vec.end(),
+         [&](int k, int l){ return pref[k] > pref[l]; });
   }
-  sort(sorted_node_vec.begin(), sorted_node_vec.end(),
-       [&](int k, int l){ return pref[k] > pref[l]; });
   int *sorted_node = &(sorted_node_vec[0]);
-
   // sample edges
   queue<int> q1;
+  // track the network for assortativity coefficients
+  assort_monitor monitor(false, store_edge ? node_vec1 : NULL,
+                         store_edge ? node_vec2 : NULL, edgeweight.begin());
+  if (assort_every > 0)
+  {
+    for (j = 0; j < new_edge_id; j++)
+    {
+      monitor.addEdge(j, seed_source[j] - 1, seed_target[j] - 1);
+    }
+  }
   GetRNGstate();
-  for (i = 0; i < nstep; i++)
+  for (i = start_step; i < nstep; i++)
   {
     m_error = false;
     n_existing = new_node_id;
@@ -279,9 +356,21 @@ Rcpp::List rpanet_linear_undirected_cpp(
       // checkDiffUnd(pref, total_pref);
       strength[node1] += edgeweight[new_edge_id];
       strength[node2] += edgeweight[new_edge_id];
-      node_vec1[new_edge_id] = node1;
-      node_vec2[new_edge_id] = node2;
-      scenario[new_edge_id] = current_scenario;
+      if (store_edge)
+      {
+        node_vec1[new_edge_id] = node1 + 1;
+        node_vec2[new_edge_id] = node2 + 1;
+        scenario[new_edge_id] = current_scenario;
+      }
+      else if (edge_fp.fp != NULL)
+      {
+        writeEdgeRecord(edge_fp.fp, node1, node2, current_scenario);
+      }
+      if (assort_every > 0)
+      {
+        monitor.addEdge(new_edge_id, node1, node2);
+      }
+      scenario_count[current_scenario]++;
       q1.push(node1);
       q1.push(node2);
       new_edge_id++;
@@ -301,17 +390,45 @@ Rcpp::List rpanet_linear_undirected_cpp(
       q1.pop();
     }
     // checkDiffUnd(pref, total_pref);
+    if (assort_every > 0 && ((i + 1) % assort_every == 0 || i == nstep - 1))
+    {
+      monitor.record(i + 1);
+    }
+    if (ckp.due(i + 1, nstep))
+    {
+      file_closer ckp_out;
+      beginCheckpoint(ckp_out, ckp, nstep, i + 1, new_node_id, new_edge_id,
+                      n_seednode, scenario_count, m.begin(), edge_fp.fp);
+      writeCheckpoint(ckp_out.fp, strength.begin(), new_node_id);
+      writeCheckpoint(ckp_out.fp, pref, new_node_id);
+      writeCheckpoint(ckp_out.fp, &total_pref, 1);
+      writeCheckpoint(ckp_out.fp, sorted_node, n_seednode);
+      endCheckpoint(ckp_out, ckp);
+    }
   }
   PutRNGstate();
+  if (edge_fp.fp != NULL)
+  {
+    closeEdgeFile(edge_fp, new_edge_id, &(edgeweight[0]));
+  }
 
+  // right-sized results, node ids and node groups start from 1
   Rcpp::List ret;
   ret["m"] = m;
   ret["nnode"] = new_node_id;
   ret["nedge"] = new_edge_id;
-  ret["node_vec1"] = node_vec1;
-  ret["node_vec2"] = node_vec2;
-  ret["pref"] = pref_vec;
-  ret["strength"] = strength;
-  ret["scenario"] = scenario;
+  if (store_edge)
+  {
+    storeEdges(ret, edgelist, edgeweight, scenario, new_edge_id);
+  }
+  ret["scenario_count"] = scenario_count;
+  if (assort_every > 0)
+  {
+    ret["assortcoef"] = monitor.result();
+  }
+  ret["strength"] = Rcpp::NumericVector(strength.begin(),
+                                        strength.begin() + new_node_id);
+  ret["pref"] = Rcpp::NumericVector(pref_vec.begin(),
+                                    pref_vec.begin() + new_node_id);
   return ret;
 }
@@ -1,181 +1,176 @@
-// #include <stdio.h>
-// #include <stdlib.h>
-// #include <math.h>
+#include <string.h>
 #include <R.h>
+#include <Rinternals.h>
 
-void netSim(double* alpha_ptr,
-	    double* beta_ptr,
-	    double* gamma_ptr,
-	    double* xi_ptr,
-	    double* delta_in_ptr,
-	    double* delta_out_ptr,
-	    int* target_n_edges_double_ptr,
-	    //output
-	    int *in_deg_counts,
-	    int *out_deg_counts,
-	    int *edge_start,
-	    int *edge_end,
-	    int *evolution
-	    )
+/**
+ * Sample a node with probability proportional to its out-/in-degree plus
+ * delta. Each edge puts its source/target node into the bag once, each node
+ * has an extra weight delta.
+ *
+ * @param node Source/target node of existing edges.
+ * @param n_edges Number of existing edges.
+ * @param n_nodes Number of existing nodes.
+ * @param delta Tuning parameter.
+ *
+ * @return Sampled node (starts from 1).
+ */
+static int sampleNodeWan(int *node, int n_edges, int n_nodes, double delta)
 {
-  double alpha = *alpha_ptr, beta = *beta_ptr, gamma = *gamma_ptr,
-    xi = *xi_ptr, delta_in = *delta_in_ptr, delta_out = *delta_out_ptr;
+  double v = unif_rand() * (n_edges + n_nodes * delta);
+  int ret;
+  if (v < n_edges)
+  {
+    return node[(int) v];
+  }
+  ret = (int) ceil((v - n_edges) / delta);
+  // numerical error
+  if (ret < 1)
+  {
+    ret = 1;
+  }
+  else if (ret > n_nodes)
+  {
+    ret = n_nodes;
+  }
+  return ret;
+}
+
+/**
+ * Directed, unweighted PA network with linear preference functions, i.e.,
+ * out-degree + delta_out and in-degree + delta_in, one new edge per step.
+ * Wan et al. (2017).
+ *
+ * The seed network can be any network, including a network returned from a
+ * previous run, so that a long simulation can be generated in chunks. The
+ * scenarios are drawn first, so that the edgelist and the degree vectors are
+ * allocated with their final sizes and returned without further copies.
+ *
+ * @param snode_seed Source nodes of the seed network (starts from 1).
+ * @param tnode_seed Target nodes of the seed network (starts from 1).
+ * @param nnode_seed Number of nodes in the seed network.
+ * @param nstep_sexp Number of steps, i.e., number of new edges.
+ * @param prob_sexp Probabilities of alpha, beta, gamma and xi scenarios.
+ * @param delta_out_sexp Tuning parameter of the source preference.
+ * @param delta_in_sexp Tuning parameter of the target preference.
+ *
+ * @return A list of edgelist (two column integer matrix), scenario,
+ *   out-degree and in-degree.
+ */
+SEXP netSim(SEXP snode_seed,
+            SEXP tnode_seed,
+            SEXP nnode_seed,
+            SEXP nstep_sexp,
+            SEXP prob_sexp,
+            SEXP delta_out_sexp,
+            SEXP delta_in_sexp)
+{
+  int nedge = LENGTH(snode_seed), nnode = asInteger(nnode_seed);
+  int nstep = asInteger(nstep_sexp), nedge_total = nedge + nstep;
+  int nnode_total = nnode, i, *snode, *tnode, *scenario, *outd, *ind;
+  double *prob = REAL(prob_sexp), u;
+  double alpha = prob[0], beta = prob[1], gamma = prob[2], xi = prob[3];
+  double delta_out = asReal(delta_out_sexp), delta_in = asReal(delta_in_sexp);
 
-    
-    int target_n_edges = *target_n_edges_double_ptr;
-    int current_n_edges;
-    int current_n_nodes;
-    int current_scenario;
-    /* int* in_deg_counts = (int*) malloc(sizeof(int) *target_n_edges*2); */
-    /* int* out_deg_counts = (int*) malloc(sizeof(int) *target_n_edges*2); */
-    /* int* edge_start = (int*) malloc(sizeof(int) *target_n_edges); */
-    /* int* edge_end = (int*) malloc(sizeof(int) *target_n_edges); */
-    /* int* evolution = (int*) malloc(sizeof(int) *target_n_edges); */
-    int this_edge_start;
-    int this_edge_end;
-    
-    edge_start[0] = 0;
-    edge_end[0] = 1;
-    evolution[0] = 1;
-    current_n_edges = 1;
-    current_n_nodes = 2;
-    current_scenario = 1;
-    in_deg_counts[0] = 0;
-    out_deg_counts[0] = 1;
-    in_deg_counts[1] = 1;
-    out_deg_counts[1] = 0;
-    
-    double u,v,w;
-    
-    // srand((time(NULL) & 0xFFFF) | (getpid() << 16));
-    GetRNGstate();
-    
-    while (current_n_edges < target_n_edges)
+  SEXP edgelist_sexp = PROTECT(allocMatrix(INTSXP, nedge_total, 2));
+  SEXP scenario_sexp = PROTECT(allocVector(INTSXP, nedge_total));
+  snode = INTEGER(edgelist_sexp);
+  tnode = snode + nedge_total;
+  scenario = INTEGER(scenario_sexp);
+
+  GetRNGstate();
+  // draw scenarios and count the number of nodes
+  for (i = 0; i < nedge; i++)
+  {
+    scenario[i] = 0;
+  }
+  for (i = nedge; i < nedge_total; i++)
+  {
+    u = unif_rand();
+    if (u <= alpha)
     {
-        // u = (double)rand() / (double)RAND_MAX;
-        // u = (double) ( rand() % 100000 / (double) 100000 );
-        u = unif_rand();
-        
-        if (u <= alpha)
-        {
-            // Scenario alpha
-            // v = (double) ( rand() % 100000 / (double) 100000 ) * (current_n_edges + current_n_nodes*delta_in);
-	    v = unif_rand() * (current_n_edges + current_n_nodes*delta_in);
-            if (v < current_n_edges)
-            {
-                this_edge_end = edge_end[(int) ceil(v)-1];
-            }
-            else
-            {
-                this_edge_end = (int) ceil((v-current_n_edges)/delta_in) -1;
-            }
-            this_edge_start = current_n_nodes;
-            in_deg_counts[this_edge_end] ++;
-            out_deg_counts[this_edge_start] = 1;
-            in_deg_counts[this_edge_start] = 0;
-            current_n_nodes++;
-            current_scenario = 1;
-        }
-        
-        else if ((u > alpha) & (u <= alpha+beta))
-        {
-            // Scenario beta
-            // v = (double) ( rand() % 100000 / (double) 100000 )* (current_n_edges + current_n_nodes*delta_in);
-	    v = unif_rand() * (current_n_edges + current_n_nodes*delta_in);
-            if (v < current_n_edges)
-            {
-                this_edge_end = edge_end[(int) ceil(v)-1];
-            }
-            else
-            {
-                this_edge_end = (int) ceil((v-current_n_edges)/delta_in) -1;
-            }
-            
-            // w = (double) ( rand() % 100000 / (double) 100000 )* (current_n_edges + current_n_nodes*delta_out);
-	    w = unif_rand() * (current_n_edges + current_n_nodes*delta_out);
-            if (w < current_n_edges)
-            {
-                this_edge_start = edge_start[(int) ceil(w)-1];
-            }
-            else
-            {
-                this_edge_start = (int) ceil((w-current_n_edges)/delta_out) -1;
-            }
-            in_deg_counts[this_edge_end] ++;
-            out_deg_counts[this_edge_start] ++;
-            current_scenario = 2;
-        }
-        
-        else if ((u > alpha+beta) & (u <= alpha+beta+gamma))
-        {
-            // Scenario gamma
-            // w = (double) ( rand() % 100000 / (double) 100000 )* (current_n_edges + current_n_nodes*delta_out);
-	    w = unif_rand() * (current_n_edges + current_n_nodes*delta_out);
-            if (w < current_n_edges)
-            {
-                this_edge_start = edge_start[(int) ceil(w)-1];
-            }
-            else
-            {
-                this_edge_start = (int) ceil((w-current_n_edges)/delta_out) -1;
-            }
-            this_edge_end = current_n_nodes;
-            in_deg_counts[this_edge_end] = 1;
-            out_deg_counts[this_edge_end] = 0;
-            out_deg_counts[this_edge_start] ++;
-            current_n_nodes++;
-            current_scenario = 3;
-        }
-        else if ((u > alpha+beta+gamma) & (u <= alpha+beta+gamma+xi))
-        {
-            // Scenario xi
-            this_edge_start = (int) current_n_nodes;
-            in_deg_counts[this_edge_start] = 0;
-            out_deg_counts[this_edge_start] = 1;
-            current_n_nodes++;
-            this_edge_end = (int) current_n_nodes;
-            in_deg_counts[this_edge_end] = 1;
-            out_deg_counts[this_edge_end] = 0;
-            current_n_nodes++;
-            current_scenario = 4;
-        }
-        
-        else // if (u > alpha+beta+gamma+xi & u <= 1)
-        {
-            // Scenario loop
-            this_edge_start = (int) current_n_nodes;
-            this_edge_end = (int) current_n_nodes;
-            in_deg_counts[this_edge_end] = 1;
-            out_deg_counts[this_edge_end] = 1;
-            current_n_nodes++;
-            current_scenario = 5;
-        }
-        
-        evolution[current_n_edges] = current_scenario;
-        edge_end[current_n_edges] = this_edge_end;
-        edge_start[current_n_edges] = this_edge_start;
-        current_n_edges ++;
+      scenario[i] = 1;
+      nnode_total++;
     }
-    PutRNGstate();
-}
-
-/* // Registering */
-/* #include <stdlib.h> */
-/* #include <R_ext/Rdynload.h> */
-/* #include <R_ext/Visibility.h>  // optional */
+    else if (u <= alpha + beta)
+    {
+      scenario[i] = 2;
+    }
+    else if (u <= alpha + beta + gamma)
+    {
+      scenario[i] = 3;
+      nnode_total++;
+    }
+    else if (u <= alpha + beta + gamma + xi)
+    {
+      scenario[i] = 4;
+      nnode_total += 2;
+    }
+    else
+    {
+      scenario[i] = 5;
+      nnode_total++;
+    }
+  }
 
-/* #define CALLDEF(name, n)  {#name, (DL_FUNC) &name, n} */
+  SEXP outd_sexp = PROTECT(allocVector(INTSXP, nnode_total));
+  SEXP ind_sexp = PROTECT(allocVector(INTSXP, nnode_total));
+  outd = INTEGER(outd_sexp);
+  ind = INTEGER(ind_sexp);
+  memset(outd, 0, sizeof(int) * nnode_total);
+  memset(ind, 0, sizeof(int) * nnode_total);
+  memcpy(snode, INTEGER(snode_seed), sizeof(int) * nedge);
+  memcpy(tnode, INTEGER(tnode_seed), sizeof(int) * nedge);
+  for (i = 0; i < nedge; i++)
+  {
+    outd[snode[i] - 1]++;
+    ind[tnode[i] - 1]++;
+  }
 
-/* static const R_CallMethodDef R_CallDef[] = { */
-/*     CALLDEF(netSim, 12), */
-/*     {NULL, NULL, 0} */
-/* }; */
+  // sample edges
+  for (i = nedge; i < nedge_total; i++)
+  {
+    switch (scenario[i])
+    {
+    case 1:
+      tnode[i] = sampleNodeWan(tnode, i, nnode, delta_in);
+      snode[i] = ++nnode;
+      break;
+    case 2:
+      snode[i] = sampleNodeWan(snode, i, nnode, delta_out);
+      tnode[i] = sampleNodeWan(tnode, i, nnode, delta_in);
+      break;
+    case 3:
+      snode[i] = sampleNodeWan(snode, i, nnode, delta_out);
+      tnode[i] = ++nnode;
+      break;
+    case 4:
+      snode[i] = ++nnode;
+      tnode[i] = ++nnode;
+      break;
+    case 5:
+      snode[i] = tnode[i] = ++nnode;
+      break;
+    }
+    outd[snode[i] - 1]++;
+    ind[tnode[i] - 1]++;
+    if ((i & 0xFFFFF) == 0)
+    {
+      R_CheckUserInterrupt();
+    }
+  }
+  PutRNGstate();
 
-/* void */
-/* attribute_visible  // optional */
-/* R_init_wdnet(DllInfo *dll) */
-/* { */
-/*     R_registerRoutines(dll, NULL, R_CallDef, NULL, NULL); */
-/*     R_useDynamicSymbols(dll, FALSE); */
-/*     R_forceSymbols(dll, TRUE); */
-/* } */
+  SEXP ret = PROTECT(allocVector(VECSXP, 4));
+  SEXP names = PROTECT(allocVector(STRSXP, 4));
+  SET_VECTOR_ELT(ret, 0, edgelist_sexp);
+  SET_VECTOR_ELT(ret, 1, scenario_sexp);
+  SET_VECTOR_ELT(ret, 2, outd_sexp);
+  SET_VECTOR_ELT(ret, 3, ind_sexp);
+  SET_STRING_ELT(names, 0, mkChar("edgelist"));
+  SET_STRING_ELT(names, 1, mkChar("scenario"));
+  SET_STRING_ELT(names, 2, mkChar("outdegree"));
+  SET_STRING_ELT(names, 3, mkChar("indegree"));
+  setAttrib(ret, R_NamesSymbol, names);
+  UNPROTECT(6);
+  return ret;
+}